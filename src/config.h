@@ -8,12 +8,38 @@
 // note, this is overritten by the IRC_USER environment variable
 #define DEFAULT_BOT_NAME "hmd_bot"
 
-// minimum milliseconds between messages
-#define CMD_RATE_LIMIT_MS 1500
+// outbound rate limits, as token buckets of <burst> commands refilled over <period> milliseconds.
+// the twitch limits are used when connected to twitch, the moderator ones if IRC_TWITCH_MOD is set.
 
-// number of backed-up commands to keep
+// non-twitch servers: everything shares one bucket
+#define RATE_IRC_BURST     1
+#define RATE_IRC_PERIOD_MS 1500
+
+// twitch: PRIVMSGs to all channels combined
+#define RATE_TWITCH_MSG_BURST     20
+#define RATE_TWITCH_MOD_MSG_BURST 100
+#define RATE_TWITCH_MSG_PERIOD_MS 30000
+
+// twitch: PRIVMSGs to a single channel (not applied for moderators)
+#define RATE_TWITCH_CHAN_BURST     1
+#define RATE_TWITCH_CHAN_PERIOD_MS 1000
+
+// twitch: JOINs
+#define RATE_TWITCH_JOIN_BURST     20
+#define RATE_TWITCH_JOIN_PERIOD_MS 10000
+
+// number of backed-up commands to keep, per priority lane
 #define CMD_QUEUE_MAX 32
 
+// placed between queued messages to the same channel when they are merged into one line
+#define CMD_COALESCE_SEP " | "
+
+// queued chat messages older than this are dropped (moderation commands, joins and parts aren't)
+#define CMD_EXPIRE_MS 30000
+
+// max number of worker threads used for run_async
+#define ASYNC_THREADS_MAX 4
+
 // main control char / prefix for commands
 #define CONTROL_CHAR "!"
 
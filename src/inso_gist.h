@@ -17,6 +17,10 @@ enum {
 	INSO_GIST_304 = 304,
 };
 
+// these wait on the network, so shouldn't be called on the bot's main thread other than from an
+// IRC_MOD_INIT_THREAD on_init or run_async work.
+// inso_gist_lock also waits, for other processes. It can be taken in run_async work and released in the
+// done callback, see mod_quotes or mod_schedule.
 inso_gist* inso_gist_open   (const char* id  , const char* user, const char* token);
 inso_gist* inso_gist_find   (const char* desc, const char* user, const char* token);
 inso_gist* inso_gist_new    (const char* desc, const char* user, const char* token, const inso_gist_file* in, bool pub);
@@ -17,18 +17,29 @@
 #include <dlfcn.h>
 #include <link.h>
 #include <execinfo.h>
+#include <pthread.h>
+#include <poll.h>
 
 #include <sys/time.h>
 #include <sys/stat.h>
 #include <sys/types.h>
 #include <sys/wait.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
 #include <sys/prctl.h>
 #include <sys/inotify.h>
 #include <sys/socket.h>
-#include <sys/un.h>
-
-#include <libircclient.h>
-#include <libirc_rfcnumeric.h>
+#include <sys/mman.h>
+#include <sys/file.h>
+#include <sys/syscall.h>
+#include <sys/uio.h>
+#include <linux/futex.h>
+
+#include <netdb.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <openssl/ssl.h>
+#include <openssl/err.h>
 #include <curl/curl.h>
 
 #include "config.h"
@@ -36,15 +47,32 @@
 #include "stb_sb.h"
 #include "inso_utils.h"
 
-#ifndef LIBIRC_OPTION_SSL_NO_VERIFY
-	#define LIBIRC_OPTION_SSL_NO_VERIFY (1 << 3)
-#endif
-
 // XXX: hack for older gcc
 #if !defined(__GNUC__) || __GNUC__ < 4 || (__GNUC__ == 4 && __GNUC_MINOR__ < 9)
 	#define __auto_type intptr_t
 #endif
 
+// max length of a line in the IRC protocol, including the \r\n
+#define IRC_LINE_MAX 512
+
+// IRCv3 allows up to 8191 bytes of tags on top of the normal line
+#define IRC_IN_BUF_SIZE 16384
+
+// if this much is waiting to be written to the server, stop sending queued commands until it drains
+#define IRC_OUT_BUF_MAX 65536
+
+// middle params + trailing param
+#define IRC_PARAMS_MAX 15
+
+#define IRC_RPL_WELCOME  1
+#define IRC_RPL_NAMREPLY 353
+
+// longest channel / nick we'll queue commands for
+#define CMD_CHAN_MAX 64
+
+// physical slots per priority lane, twice the logical limit to leave room for out of order sends
+#define CMD_RING_SIZE (CMD_QUEUE_MAX * 2)
+
 _Static_assert(sizeof(intptr_t)   == sizeof(void*), "uh oh");
 _Static_assert(sizeof(void (*)()) == sizeof(void*), "uh oh");
 
@@ -52,11 +80,100 @@ _Static_assert(sizeof(void (*)()) == sizeof(void*), "uh oh");
  * Types, global vars, macros *
  * ****************************/
 
+// a module's journal is a set of files next to its data file, <name>.data.journal.<gen>, holding records
+// that apply on top of the data file. They start with a JournalHeader, followed by JournalRecords + data.
+#define JOURNAL_MAGIC       0x314a4249 // "IBJ1"
+#define JOURNAL_COMPACT_MIN (256 << 10) // compact when a journal is bigger than this and the data file
+#define JOURNAL_RECORD_MAX  (16 << 20)
+
+typedef struct JournalHeader_ {
+	uint32_t magic;
+	uint32_t gen;
+	uint64_t base_ino; // inode of the data file the records apply to, so ones covered by a newer save are skipped
+} JournalHeader;
+
+typedef struct JournalRecord_ {
+	uint32_t len;
+	uint32_t hash; // FNV-1a of the data, to spot a torn write at the end of the file
+} JournalRecord;
+
+typedef struct ModJournal_ {
+	int       fd; // -1 until the first append after init / a save
+	uint32_t  gen;
+	uint64_t  size;
+	uint64_t  compact_at;
+	int       compact_timer;
+} ModJournal;
+
+// a save being written in the background to tmp_path, which is renamed over the data file when it's done.
+// either by a worker thread from data (journal compaction), or by a forked child calling on_save (INSOBOT_BG_SAVE).
+typedef struct SaveSnapshot_ {
+	char*    tmp_path;
+	int      tmp_fd;
+	uint64_t tmp_ino;
+	uint32_t gen;       // journals before this gen are covered by the snapshot
+	char*    data;
+	size_t   data_len;
+	pid_t    pid;       // of the child, for bg saves
+	int      pidfd;
+	bool     ok;        // set once it has been written and synced
+} SaveSnapshot;
+
+enum {
+	MOD_INIT_READY,
+	MOD_INIT_PENDING, // on_init is running on a worker (IRC_MOD_INIT_THREAD), or the module called init_later
+	MOD_INIT_FAILED,  // removed by util_module_reap_cb, it can't be done from inside its own callbacks
+};
+
+// on_init of an IRC_MOD_INIT_THREAD module, run by util_module_init_work
+typedef struct ModInitJob_ {
+	const IRCCoreCtx* core_ctx;
+	IRCModuleCtx*     ctx;
+	bool              ok;
+	int64_t           start, end;
+	uint64_t          ns; // for the on_init stats, start & end are only ms
+} ModInitJob;
+
+// ms since startup_ms, printed by util_startup_report once every module is ready
+typedef struct ModTimeline_ {
+	int64_t     load_start, load_end; // dlopen
+	int64_t     init_start, init_end; // on_init, or on_import_state
+	int64_t     ready;                // when it started getting callbacks
+	const char* mode;
+} ModTimeline;
+
+// log-linear buckets of ns like an HDR histogram: values below STATS_SUB_COUNT get a bucket each, then every power of
+// two is split into STATS_SUB_COUNT, so a bucket is within 1/STATS_SUB_COUNT of its values. Anything over STATS_MAX_BITS is clamped.
+#define STATS_SUB_BITS  3
+#define STATS_SUB_COUNT (1 << STATS_SUB_BITS)
+#define STATS_MAX_BITS  36 // ~68s
+#define STATS_BUCKETS   ((STATS_MAX_BITS - STATS_SUB_BITS + 1) * STATS_SUB_COUNT)
+
+typedef struct ModHist_ {
+	uint64_t count;
+	uint64_t total_ns;
+	uint64_t max_ns;
+	uint32_t buckets[STATS_BUCKETS];
+} ModHist;
+
 typedef struct Module_ {
 	char* lib_path;
 	void* lib_handle;
 	IRCModuleCtx* ctx;
 	size_t ctx_size;
+	uint32_t ipc_id; // hash of ctx->name, used to route IPC messages
+	int log_level;   // IRC_LOG_*, messages below this are dropped
+	ModJournal journal;
+	SaveSnapshot* snapshot; // in progress
+	void* state;            // from on_export_state, waiting for the new instance's on_import_state
+	size_t state_len;
+	uint32_t state_version;
+	int save_timer;
+	bool save_pending; // save_me was called during a background save
+	int init_state;    // MOD_INIT_*, only ready modules get callbacks
+	ModInitJob* init_job;
+	ModTimeline timeline;
+	ModHist** stats; // MOD_STAT_COUNT, each allocated when first used
 	bool needs_reload, data_modified;
 } Module;
 
@@ -67,65 +184,485 @@ typedef struct INotifyWatch {
 
 typedef struct INotifyData_ {
 	int fd;
-	INotifyWatch module, data, ipc;
+	INotifyWatch module, data;
 } INotifyData;
 
+enum {
+	IRC_STATE_DISCONNECTED,
+	IRC_STATE_CONNECTING,    // waiting for the non-blocking connect() to finish
+	IRC_STATE_HANDSHAKE,     // TLS handshake in progress
+	IRC_STATE_REGISTERING,   // sent NICK / USER, waiting for RPL_WELCOME
+	IRC_STATE_CONNECTED,
+};
+
+// the connection to the IRC server. lines are read into a fixed buffer and parsed in place.
+typedef struct IRCConn_ {
+	int      state;
+	int      fd;
+	SSL_CTX* ssl_ctx;
+	SSL*     ssl;
+	bool     ssl_want_write;
+	char     in[IRC_IN_BUF_SIZE];
+	size_t   in_len;
+	char*    out;     // pending output, sb
+	size_t   out_off; // how much of out was already written
+} IRCConn;
+
+// a parsed line, all pointers point into IRCConn.in
+typedef struct IRCMsg_ {
+	char*  tags;
+	char*  prefix;
+	char*  cmd;
+	char*  params[IRC_PARAMS_MAX + 1];
+	size_t num_params;
+} IRCMsg;
+
+// slots are preallocated and never move, so a command can be pointed to while callbacks queue more.
 typedef struct IRCCmd_ {
 	size_t id;
 	int cmd;
-	char *chan, *data;
+	int state;
+	bool filtered;
+	int64_t queued_ms;
+	char chan[CMD_CHAN_MAX];
+	char data[IRC_LINE_MAX];
 } IRCCmd;
 
-typedef struct IPCAddress_ {
-	int id;
-	struct sockaddr_un addr;
-} IPCAddress;
+// head & tail only ever increase, slots are at (n % CMD_RING_SIZE). Commands can be sent out of order,
+// which leaves free slots behind the head, these are skipped once they reach it.
+typedef struct IRCCmdRing_ {
+	IRCCmd   slots[CMD_RING_SIZE];
+	uint32_t head, tail;
+	uint32_t count;
+	uint32_t high_water;
+	uint64_t dropped;
+} IRCCmdRing;
+
+typedef struct RateBucket_ {
+	double tokens;
+	int64_t last_ms;
+} RateBucket;
+
+typedef struct RateLimits_ {
+	const char* name;
+	int msg_burst , msg_period;
+	int chan_burst, chan_period; // 0 = no per-channel limit
+	int join_burst, join_period; // 0 = share the msg bucket
+} RateLimits;
+
+typedef void (*IRCFdCallback)(int fd, int events, void* arg);
+
+typedef struct IRCFdWatch_ {
+	int fd;
+	int events;
+	IRCModuleCtx* owner; // NULL for the core's own fds
+	IRCFdCallback cb;
+	void* arg;
+} IRCFdWatch;
+
+// a synthetic event from gen_event, the strings are offsets into its IRCEventQueue's string buffer
+typedef struct IRCEvent_ {
+	int    type; // IRC_CB_*
+	size_t chan;
+	size_t origin;
+	size_t msg;  // the byte before the msg is always a NUL
+} IRCEvent;
+
+typedef struct IRCEventQueue_ {
+	IRCEvent* events;
+	char*     strings;
+} IRCEventQueue;
+
+typedef void (*IRCTimerCallback)(int id, void* arg);
+
+typedef struct IRCTimer_ {
+	int              id;
+	int64_t          due_ms;    // util_mono_ms time
+	int64_t          repeat_ms; // 0 = only once
+	IRCModuleCtx*    owner;
+	IRCTimerCallback cb;
+	void*            arg;
+} IRCTimer;
+
+typedef struct IRCHTTPReq_ {
+	CURL* curl;
+	IRCModuleCtx* owner;
+	void (*cb)(const IRCHTTPResult*, void*);
+	void* arg;
+	char* data;
+	struct curl_slist* headers;
+} IRCHTTPReq;
+
+typedef struct IRCAsyncJob_ {
+	void (*work)(void*);
+	void (*done)(void*);
+	void* arg;
+	IRCModuleCtx* owner;
+	bool cancel_done; // done is still called if the owner is unloaded first, so that it can free arg
+	struct IRCAsyncJob_* next;
+} IRCAsyncJob;
+
+typedef struct IRCAsyncQueue_ {
+	IRCAsyncJob *head, *tail;
+} IRCAsyncQueue;
+
+// size of the data part of the shared IPC ring, messages can be up to a quarter of this
+#define IPC_RING_SIZE (1 << 20)
+#define IPC_RING_MAGIC 0x49534252 // 'ISBR'
+#define IPC_RING_VERSION 1
+
+// how long to wait for another instance to finish writing a message before skipping it
+#define IPC_STALL_MS 1000
+
+// the ring is shared by all instances on the machine through a file in XDG_RUNTIME_DIR/insobot/.
+// writers reserve space by advancing head, and every instance reads all of it with its own position.
+typedef struct IPCRing_ {
+	uint32_t magic;
+	uint32_t version;
+	uint64_t size;
+	uint64_t head;     // total bytes reserved so far, head % size is where the next message goes
+	uint32_t doorbell; // futex, incremented after each message is written
+	uint32_t pad;
+	char     data[] __attribute__((aligned(64)));
+} IPCRing;
+
+// header of each message in the ring, always 8-byte aligned
+typedef struct IPCRecord_ {
+	uint64_t pos;      // the record's position in the ring once written, ~position while being written
+	uint32_t len;      // including this header and alignment padding
+	uint32_t data_len;
+	int32_t  sender;   // pid
+	int32_t  target;   // pid, 0 = everyone
+	uint32_t mod_id;   // Module.ipc_id of the sender, 0 for padding at the end of the ring
+	uint32_t pad;
+} IPCRecord;
+
+// a module's command that a word in the command index should be dispatched to
+typedef struct CmdHandler_ {
+	int mod; // index into irc_modules
+	int cmd; // index into that module's commands
+} CmdHandler;
+
+// header for entries in a NameTable, hashed by name using RFC1459 casemapping
+typedef struct IRCName_ {
+	char*            name;
+	uint32_t         hash;
+	struct IRCName_* next;
+} IRCName;
+
+typedef struct NameTable_ {
+	IRCName** buckets;
+	size_t    size; // power of 2
+	size_t    count;
+} NameTable;
+
+typedef struct IRCChan_ IRCChan;
+typedef struct IRCNick_ IRCNick;
+
+typedef struct IRCMembership_ {
+	IRCChan* chan;
+	size_t   index; // position in chan->nicks
+} IRCMembership;
+
+struct IRCChan_ {
+	IRCName   key;
+	char**    nicks;   // returned directly by get_nicks, points to the IRCNick names
+	IRCNick** members; // parallel to nicks
+};
+
+struct IRCNick_ {
+	IRCName        key;
+	IRCMembership* chans;
+};
+
+// an entry in intern_table
+typedef struct InternName_ {
+	IRCName  key;
+	uint32_t refs;   // from intern_ref, it's freed when they're all released
+	bool     pinned; // given out by intern, so it's kept until the bot exits
+} InternName;
+
+// an entry in rate_target_table
+typedef struct TargetBucket_ {
+	IRCName    key;
+	RateBucket bucket;
+} TargetBucket;
+
+// cached results of on_meta for one channel, as bitmaps of module indices for each IRC_CB_* id
+typedef struct PermCache_ {
+	char*     chan;
+	uint64_t* known;   // PERM_CB_COUNT * perm_cache_words
+	uint64_t* enabled; // same layout as known
+} PermCache;
+
+typedef struct CmdIndexEntry_ {
+	char*       word; // lowercase, NULL if the slot is empty
+	uint32_t    hash;
+	CmdHandler* handlers; // in irc_modules order
+} CmdIndexEntry;
 
 enum { MOD_GET_SONAME, MOD_GET_CTXNAME };
 
 enum { IRC_CMD_JOIN, IRC_CMD_PART, IRC_CMD_MSG, IRC_CMD_RAW };
 
-static IRCCmd* cmd_queue;
-static uint32_t prev_cmd_ms;
-static size_t last_cmd_id;
+enum { CMD_FREE, CMD_QUEUED, CMD_SENDING };
+
+// HIGH: moderation, joins & parts. NORMAL: replies to chat. LOW: everything else (timers, notifications)
+enum { CMD_LANE_HIGH, CMD_LANE_NORMAL, CMD_LANE_LOW, CMD_LANE_COUNT };
+
+static const RateLimits rate_profiles[] = {
+	{
+		"irc",
+		RATE_IRC_BURST, RATE_IRC_PERIOD_MS,
+		0, 0,
+		0, 0,
+	}, {
+		"twitch",
+		RATE_TWITCH_MSG_BURST , RATE_TWITCH_MSG_PERIOD_MS,
+		RATE_TWITCH_CHAN_BURST, RATE_TWITCH_CHAN_PERIOD_MS,
+		RATE_TWITCH_JOIN_BURST, RATE_TWITCH_JOIN_PERIOD_MS,
+	}, {
+		"twitch moderator",
+		RATE_TWITCH_MOD_MSG_BURST, RATE_TWITCH_MSG_PERIOD_MS,
+		0, 0,
+		RATE_TWITCH_JOIN_BURST, RATE_TWITCH_JOIN_PERIOD_MS,
+	}
+};
+
+static IRCCmdRing        cmd_queue[CMD_LANE_COUNT];
+static uint32_t          cmd_queue_high_water;
+static size_t            last_cmd_id;
+static const RateLimits* rate_limits = rate_profiles;
+static RateBucket        rate_msg_bucket, rate_join_bucket;
+static NameTable         rate_target_table; // of TargetBucket
+static int               rate_sweep_timer;
+
+// how often idle per-target buckets are looked for, see util_rate_sweep_cb
+#define RATE_SWEEP_MS 60000
+static bool              handling_msg;
 
-static irc_session_t* irc_ctx;
+static IRCConn irc_conn = { .fd = -1 };
 
 static Module* irc_modules;
 static Module** mod_call_stack;
 static IRCModuleCtx** chan_mod_list;
 static IRCModuleCtx** global_mod_list;
 static bool mod_list_dirty = true;
+static bool mod_reloading;       // inside util_reload_modules, which deals with modules that become ready during it
+static int  mod_reap_timer;      // removes modules whose init failed after util_reload_modules
+static int64_t startup_ms;       // util_mono_ms when main started
+static bool    startup_reported; // util_startup_report has printed the timeline
+
+// index of a callback in IRCModuleCtx, used to find the list of modules implementing it
+#define MOD_CB_SLOT(ptr) (offsetof(IRCModuleCtx, ptr) / sizeof(void*))
+#define MOD_CB_COUNT     (sizeof(IRCModuleCtx) / sizeof(void*))
+
+// stats are kept for each callback slot, and these other ways the core calls into a module
+enum {
+	MOD_STAT_TIMER = MOD_CB_COUNT,
+	MOD_STAT_FD,
+	MOD_STAT_HTTP,
+	MOD_STAT_ASYNC,
+	MOD_STAT_COUNT,
+};
+
+static const char* const mod_stat_names[MOD_STAT_COUNT] = {
+	[MOD_CB_SLOT(on_init)]         = "on_init",
+	[MOD_CB_SLOT(on_quit)]         = "on_quit",
+	[MOD_CB_SLOT(on_connect)]      = "on_connect",
+	[MOD_CB_SLOT(on_msg)]          = "on_msg",
+	[MOD_CB_SLOT(on_action)]       = "on_action",
+	[MOD_CB_SLOT(on_pm)]           = "on_pm",
+	[MOD_CB_SLOT(on_join)]         = "on_join",
+	[MOD_CB_SLOT(on_part)]         = "on_part",
+	[MOD_CB_SLOT(on_nick)]         = "on_nick",
+	[MOD_CB_SLOT(on_cmd)]          = "on_cmd",
+	[MOD_CB_SLOT(on_save)]         = "on_save",
+	[MOD_CB_SLOT(on_modified)]     = "on_modified",
+	[MOD_CB_SLOT(on_meta)]         = "on_meta",
+	[MOD_CB_SLOT(on_mod_msg)]      = "on_mod_msg",
+	[MOD_CB_SLOT(on_tick)]         = "on_tick",
+	[MOD_CB_SLOT(on_stdin)]        = "on_stdin",
+	[MOD_CB_SLOT(on_msg_out)]      = "on_msg_out",
+	[MOD_CB_SLOT(on_ipc)]          = "on_ipc",
+	[MOD_CB_SLOT(on_filter)]       = "on_filter",
+	[MOD_CB_SLOT(on_unknown)]      = "on_unknown",
+	[MOD_CB_SLOT(on_names)]        = "on_names",
+	[MOD_CB_SLOT(on_twitch)]       = "on_twitch",
+	[MOD_CB_SLOT(on_export_state)] = "on_export_state",
+	[MOD_CB_SLOT(on_import_state)] = "on_import_state",
+	[MOD_STAT_TIMER]               = "timer",
+	[MOD_STAT_FD]                  = "watch_fd",
+	[MOD_STAT_HTTP]                = "http_request",
+	[MOD_STAT_ASYNC]               = "run_async",
+};
+
+// modules built against an older IRCModuleCtx don't have the newer callbacks at all
+#define MOD_HAS_CB(m, ptr) ((m)->ctx_size >= offsetof(IRCModuleCtx, ptr) + sizeof(void*) && (m)->ctx->ptr)
+
+// modules implementing each callback in priority order, indexed by MOD_CB_SLOT.
+// these point into irc_modules, so must be marked dirty whenever it is changed.
+static Module** mod_subs[MOD_CB_COUNT];
+static bool     mod_subs_dirty = true;
+
+#define PERM_CB_COUNT (IRC_CB_PM + 1)
+
+// per channel cache of util_check_perms, cleared when modules are reloaded or a module calls perms_changed
+static PermCache* perm_cache;
+static size_t     perm_cache_words;
+
+// while a run of queued events for the same channel is handled, its PermCache is only searched for once
+static const char* perm_batch_chan;
+static int         perm_batch_index = -1;
+
+// open addressing hash table of command words, rebuilt whenever modules are (re)loaded
+static CmdIndexEntry* cmd_index;
+static size_t         cmd_index_size;
 
 static const char *user, *pass, *serv, *port;
 static char* bot_nick;
 
-static char**  channels;
-static char*** chan_nicks;
+// membership registry, nick -> channels and channel -> nicks.
+// channels is the null terminated list returned by get_channels, in the order they were joined.
+static char**    channels;
+static NameTable chan_table;
+static NameTable nick_table;
 
-static INotifyData inotify;
+// strings given out by the intern core functions, InternName entries
+static NameTable intern_table;
 
-static struct timeval idle_tv;
-static bool ping_sent;
+static INotifyData inotify;
 
-static int         ipc_socket;
-static IPCAddress  ipc_self;
-static IPCAddress* ipc_peers;
+static int         epoll_fd;
+static IRCFdWatch* fd_watches;
+
+static CURLM*       curl_multi;
+static IRCHTTPReq** http_reqs;
+static int64_t      http_timeout_ms = -1;
+
+static pthread_t       async_threads[ASYNC_THREADS_MAX];
+static IRCAsyncJob*    async_running[ASYNC_THREADS_MAX];
+static int             async_num_threads;
+static int             async_eventfd = -1;
+static bool            async_quit;
+static IRCAsyncQueue   async_pending, async_done;
+static pthread_mutex_t async_mutex     = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t  async_work_cond = PTHREAD_COND_INITIALIZER;
+static pthread_cond_t  async_idle_cond = PTHREAD_COND_INITIALIZER;
+
+// set while a module that's being unloaded gets the callbacks of its unfinished http requests & async jobs
+static bool mod_cancelling;
+
+// events are added to event_queues[event_queue_cur], the other one is the one being handled
+static IRCEventQueue event_queues[2];
+static int           event_queue_cur;
+
+// min-heap ordered by due_ms
+static IRCTimer* timers;
+static int       last_timer_id;
+
+// on_tick is only called this often, and only woken up for if a module has it
+#define TICK_INTERVAL_MS 250
+static int64_t next_tick_ms;
+
+// the server is PINGed after this long without receiving anything, and dropped if it still doesn't reply.
+#define IRC_PING_MS    60000
+#define IRC_RESTART_MS 90000
+static int64_t irc_last_recv_ms;
+static bool    ping_sent;
+
+// events that reach on_unknown are logged at most UNKNOWN_LOG_MAX times per minute, unless disabled
+#define UNKNOWN_LOG_MAX 10
+static bool     unknown_log = true;
+static int64_t  unknown_log_window;
+static unsigned unknown_log_count, unknown_log_skipped;
+
+static IPCRing*  ipc_ring;
+static uint64_t  ipc_read_pos;
+static int64_t   ipc_stall_ms;    // when the current read position was first found to be incomplete
+static int       ipc_stall_timer;
+static uint8_t*  ipc_recv_buf;    // sb
+static int       ipc_eventfd = -1;
+static pthread_t ipc_thread;
+static bool      ipc_quit;
 
 static sig_atomic_t running = 1;
 
 static bool send_msg_called;
 
-static char   irc_tag_buf[512];
-static char** irc_tag_ptrs;
-static bool   have_tag_hack;
+static bool bg_save; // INSOBOT_BG_SAVE
+
+// IRCv3 tags of the current message, only parsed once a module asks for them.
+// irc_tag_raw points into the connection's input buffer and is unescaped in place, so the keys & values
+// are only valid while handling the message.
+static char*       irc_tag_raw;
+static bool        irc_tags_parsed;
+static char**      irc_tag_ptrs;  // key, value pairs
+static int*        irc_tag_index; // hash of key -> pair index + 1, 0 = empty
 
 static int pipe_fds[2];
 static int debug_pipe[2];
+
+// memory that's mapped by the parent process before it forks, so it's still there when the bot is restarted.
+// modules get named segments of it with warm_get, which are kept if their checksum matches what was last committed.
+#define WARM_SIZE         (16 << 20)
+#define WARM_MAX_SEGMENTS 64
+#define WARM_MAGIC        0x4d524157 // "WARM"
+#define WARM_QUICK_CRASH  60 // seconds, the state is thrown away if the bot crashes this soon twice in a row
+
+typedef struct WarmSegment_ {
+	char     name[48]; // <module name>/<segment name>
+	uint32_t version;
+	uint32_t checksum; // FNV-1a of the data as of the last warm_commit
+	uint64_t offset;   // into WarmRegion.data
+	uint64_t size;
+	uint64_t capacity;
+	uint32_t committed;
+} WarmSegment;
+
+typedef struct WarmRegion_ {
+	uint32_t    magic;
+	uint32_t    count;
+	uint64_t    used;
+	WarmSegment segments[WARM_MAX_SEGMENTS];
+	uint8_t     data[] __attribute__ ((aligned (64)));
+} WarmRegion;
+
+static WarmRegion* warm;
+
+// log messages are put into a ring by whichever thread logs them, and written out by log_thread.
+// anything printed to stdout / stderr goes through log_capture_fd to the same thread, so it gets timestamped too.
+#define LOG_RING_SLOTS 1024 // must be a power of 2
+#define LOG_TEXT_MAX   488
+
+typedef struct LogEntry_ {
+	uint64_t seq;     // == pos + 1 once written, pos + LOG_RING_SLOTS once read
+	int64_t  time_ms; // CLOCK_REALTIME
+	int      level;
+	char     mod[20];
+	uint32_t len;
+	char     text[LOG_TEXT_MAX];
+} LogEntry;
+
+enum { LOG_FMT_TEXT, LOG_FMT_JSON };
+
+static LogEntry  log_ring[LOG_RING_SLOTS];
+static uint64_t  log_head;
+static uint64_t  log_tail;     // only touched by log_thread
+static uint64_t  log_dropped;
+static uint32_t  log_sleeping; // set by log_thread before it waits for log_eventfd
+static int       log_eventfd    = -1; // -1 when the log thread isn't running, messages are printed directly then
+static int       log_out_fd     = -1; // the original stdout
+static int       log_capture_fd = -1; // read end of the pipe stdout & stderr are pointed at
+static int       log_format;
+static int       log_level_core    = IRC_LOG_INFO; // for messages logged outside of a module callback
+static int       log_level_default = IRC_LOG_INFO; // for newly added modules
+static bool      log_quit;
+static pthread_t log_thread;
 static const char* debug_chan;
 
+// params point into a writable buffer, and the byte before each param can be overwritten too.
 #define IRC_CALLBACK_BASE(name, event_type) static void irc_##name ( \
-	irc_session_t* session, \
 	event_type     event,   \
 	const char*    origin,  \
 	const char**   params,  \
@@ -135,75 +672,470 @@ static const char* debug_chan;
 #define IRC_STR_CALLBACK(name) IRC_CALLBACK_BASE(name, const char*)
 #define IRC_NUM_CALLBACK(name) IRC_CALLBACK_BASE(name, unsigned int)
 
+static inline int64_t util_stats_now(void){
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec * 1000000000LL + ts.tv_nsec;
+}
+
+static inline size_t util_stats_bucket(uint64_t ns){
+	if(ns < STATS_SUB_COUNT) return ns;
+	if(ns >> STATS_MAX_BITS) ns = (1ULL << STATS_MAX_BITS) - 1;
+
+	const int shift = (63 - __builtin_clzll(ns)) - STATS_SUB_BITS;
+	return (shift + 1) * STATS_SUB_COUNT + ((ns >> shift) & (STATS_SUB_COUNT - 1));
+}
+
+// the highest value that would go in bucket i
+static uint64_t util_stats_bucket_max(size_t i){
+	if(i < STATS_SUB_COUNT) return i;
+
+	const int shift = (i / STATS_SUB_COUNT) - 1;
+	return ((uint64_t)(STATS_SUB_COUNT + (i % STATS_SUB_COUNT) + 1) << shift) - 1;
+}
+
+static void util_stats_add(Module* m, size_t slot, uint64_t ns){
+	if(!m->stats && !(m->stats = calloc(MOD_STAT_COUNT, sizeof(*m->stats)))) return;
+
+	ModHist* h = m->stats[slot];
+	if(!h && !(h = m->stats[slot] = calloc(1, sizeof(*h)))) return;
+
+	h->count    += 1;
+	h->total_ns += ns;
+	h->max_ns    = INSO_MAX(h->max_ns, ns);
+	h->buckets[util_stats_bucket(ns)] += 1;
+}
+
+// m can be NULL for the core's own callbacks, which aren't counted
+static inline void util_stats_record(Module* m, size_t slot, int64_t start){
+	if(m) util_stats_add(m, slot, util_stats_now() - start);
+}
+
+static void util_stats_free(Module* m){
+	if(!m->stats) return;
+
+	for(size_t i = 0; i < MOD_STAT_COUNT; ++i){
+		free(m->stats[i]);
+	}
+	free(m->stats);
+	m->stats = NULL;
+}
+
 #define IRC_MOD_CALL(mod, ptr, args) ({                                       \
 	sb_push(mod_call_stack, mod);                                             \
+	const int64_t _call_start = util_stats_now();                             \
 	__auto_type ret = (mod)->ctx->ptr ?                                       \
 		__builtin_choose_expr(                                                \
 			__builtin_types_compatible_p(typeof((mod)->ctx->ptr args), void), \
 			((mod)->ctx->ptr args, (int)0),                                   \
 			(mod)->ctx->ptr args                                              \
 		) : 0;                                                                \
+	if((mod)->ctx->ptr){                                                      \
+		util_stats_record(mod, MOD_CB_SLOT(ptr), _call_start);                \
+	}                                                                         \
 	sb_pop(mod_call_stack);                                                   \
 	ret;                                                                      \
 })
 
-#define IRC_MOD_CALL_ALL(ptr, args)                             \
-	for(Module* m = irc_modules; m < sb_end(irc_modules); ++m){ \
-		IRC_MOD_CALL(m, ptr, args);                             \
-	}
-
-#define IRC_MOD_CALL_ALL_CHECK(ptr, args, id)                   \
-	for(Module* m = irc_modules; m < sb_end(irc_modules); ++m){ \
-		if(                                                     \
-			(m->ctx->flags & IRC_MOD_GLOBAL) ||                 \
-			util_check_perms(m->ctx->name, params[0], id)       \
-		){                                                      \
-			IRC_MOD_CALL(m, ptr, args);                         \
-		}                                                       \
+#define IRC_MOD_CALL_ALL(ptr, args)                                      \
+	for(Module **sub = util_mod_subs(MOD_CB_SLOT(ptr)), **sub_end = sb_end(sub); sub < sub_end; ++sub){ \
+		Module* m = *sub;                                                \
+		IRC_MOD_CALL(m, ptr, args);                                      \
 	}
 
-#define IRC_MOD_CALL_ALL_ABI(ptr, args, abi)                    \
-	for(Module* m = irc_modules; m < sb_end(irc_modules); ++m){ \
-		if(ABI_CHECK(m, abi)) IRC_MOD_CALL(m, ptr, args);       \
+#define IRC_MOD_CALL_ALL_CHECK(ptr, args, id)                            \
+	for(Module **sub = util_mod_subs(MOD_CB_SLOT(ptr)), **sub_end = sb_end(sub); sub < sub_end; ++sub){ \
+		Module* m = *sub;                                                \
+		if(                                                              \
+			(m->ctx->flags & IRC_MOD_GLOBAL) ||                          \
+			util_check_perms(m, params[0], id)                           \
+		){                                                               \
+			IRC_MOD_CALL(m, ptr, args);                                  \
+		}                                                                \
 	}
 
-#define ABI_FILTER  24
-#define ABI_UNKNOWN 25
-#define ABI_CHECK(m, abi) ((m)->ctx_size >= (sizeof(void*)*(abi)))
-
 /*********************************
  * Required forward declarations *
  *********************************/
 
+IRC_STR_CALLBACK(on_connect);
+IRC_STR_CALLBACK(on_chat_msg);
+IRC_STR_CALLBACK(on_action);
+IRC_STR_CALLBACK(on_pm);
 IRC_STR_CALLBACK(on_join);
 IRC_STR_CALLBACK(on_part);
+IRC_STR_CALLBACK(on_quit);
+IRC_STR_CALLBACK(on_nick);
+IRC_STR_CALLBACK(on_unknown);
+IRC_NUM_CALLBACK(on_numeric);
+IRC_NUM_CALLBACK(on_twitch);
+
+static const char* core_get_tag_by_name(const char* key);
 
 static const char* core_get_datafile(void);
-static IPCAddress* util_ipc_add(const char* name);
-static void        util_ipc_del(const char* name);
+static size_t      core_send_msg(const char* chan, const char* fmt, ...);
+static void        util_irc_fd_update(void);
+static bool        util_irc_send(const char* fmt, ...) __attribute__ ((format (printf, 1, 2)));
 
 /****************
  * Helper funcs *
  ****************/
 
-static void util_log_proc(int fd, pid_t pid){
-	char text_buf[1024];
-	char time_buf[64];
+static bool util_write_all(int fd, const char* buf, size_t len){
+	while(len){
+		ssize_t n = write(fd, buf, len);
+		if(n == -1){
+			if(errno == EINTR) continue;
+			return false;
+		}
+		buf += n;
+		len -= n;
+	}
+	return true;
+}
 
-	FILE* f = fdopen(dup(fd), "r");
+static void util_log_proc(int fd, pid_t pid){
+	char buf[4096];
 
+	// the child's log thread has already timestamped everything, so just pass it along.
 	while(running){
-		if(!fgets(text_buf, sizeof(text_buf), f)) break;
-		time_t now = time(0);
-		strftime(time_buf, sizeof(time_buf), "[%F %T]", localtime(&now));
-		printf("%s %s", time_buf, text_buf);
+		ssize_t n = read(fd, buf, sizeof(buf));
+		if(n == -1 && errno == EINTR) continue;
+		if(n <= 0) break;
+		util_write_all(STDOUT_FILENO, buf, n);
+	}
+}
+
+static const char* log_level_names[] = IRC_LOG_LEVEL_NAMES;
+
+static int util_log_level_parse(const char* str){
+	for(size_t i = 0; i < ARRAY_SIZE(log_level_names); ++i){
+		if(strcasecmp(str, log_level_names[i]) == 0) return i;
+	}
+	return -1;
+}
+
+static int64_t util_log_now_ms(void){
+	struct timespec ts;
+	clock_gettime(CLOCK_REALTIME, &ts);
+	return (ts.tv_sec * 1000) + (ts.tv_nsec / 1000000);
+}
+
+static void util_log_v(int level, const char* mod, const char* fmt, va_list v){
+
+	if(log_eventfd == -1){
+		if(mod) fprintf(stderr, "%s: ", mod);
+		vfprintf(stderr, fmt, v);
+		return;
+	}
+
+	// claim a slot, if the ring is full the message is dropped (and counted) rather than waiting for the log thread.
+	uint64_t pos = __atomic_load_n(&log_head, __ATOMIC_RELAXED);
+	LogEntry* e;
+
+	for(;;){
+		e = log_ring + (pos & (LOG_RING_SLOTS - 1));
+		uint64_t seq = __atomic_load_n(&e->seq, __ATOMIC_ACQUIRE);
+
+		if(seq == pos){
+			if(__atomic_compare_exchange_n(&log_head, &pos, pos + 1, true, __ATOMIC_RELAXED, __ATOMIC_RELAXED)){
+				break;
+			}
+		} else if(seq < pos){
+			__atomic_fetch_add(&log_dropped, 1, __ATOMIC_RELAXED);
+			return;
+		} else {
+			pos = __atomic_load_n(&log_head, __ATOMIC_RELAXED);
+		}
+	}
+
+	e->time_ms = util_log_now_ms();
+	e->level   = level;
+	snprintf(e->mod, sizeof(e->mod), "%s", mod ? mod : "");
+
+	int len = vsnprintf(e->text, sizeof(e->text), fmt, v);
+	len = INSO_MIN(INSO_MAX(len, 0), (int)sizeof(e->text) - 1);
+	while(len && e->text[len-1] == '\n') --len;
+	e->len = len;
+
+	__atomic_store_n(&e->seq, pos + 1, __ATOMIC_RELEASE);
+
+	// only poke the log thread if it's waiting, so a burst of messages costs one wakeup.
+	__atomic_thread_fence(__ATOMIC_SEQ_CST);
+	if(__atomic_exchange_n(&log_sleeping, 0, __ATOMIC_SEQ_CST)){
+		uint64_t one = 1;
+		if(write(log_eventfd, &one, sizeof(one)) == -1){
+			// nothing useful to do about it
+		}
+	}
+}
+
+// main thread only, since it uses mod_call_stack to find the module (and its level) to log as.
+// outside of any module's callback, it logs as the core.
+static void util_log_as_caller(int level, const char* fmt, va_list v){
+	Module* m = sb_count(mod_call_stack) ? sb_last(mod_call_stack) : NULL;
+	if(level < (m ? m->log_level : log_level_core)) return;
+
+	util_log_v(level, m ? m->ctx->name : NULL, fmt, v);
+}
+
+static void util_log(int level, const char* fmt, ...) __attribute__ ((format (printf, 2, 3)));
+static void util_log(int level, const char* fmt, ...){
+	va_list v;
+	va_start(v, fmt);
+	util_log_as_caller(level, fmt, v);
+	va_end(v);
+}
+
+// buffered output of the log thread, flushed with one write per batch of messages.
+static char   log_out_buf[65536];
+static size_t log_out_len;
+
+static void util_log_out_flush(void){
+	util_write_all(log_out_fd, log_out_buf, log_out_len);
+	log_out_len = 0;
+}
+
+static void util_log_out(const char* str, size_t len){
+	while(len){
+		if(log_out_len == sizeof(log_out_buf)){
+			util_log_out_flush();
+		}
+		size_t n = INSO_MIN(len, sizeof(log_out_buf) - log_out_len);
+		memcpy(log_out_buf + log_out_len, str, n);
+		log_out_len += n;
+		str += n;
+		len -= n;
+	}
+}
+
+static void util_log_out_json_str(const char* str, size_t len){
+	util_log_out("\"", 1);
+	for(const char* p = str; p < str + len; ++p){
+		char esc[8];
+		if(*p == '"' || *p == '\\'){
+			esc[0] = '\\';
+			esc[1] = *p;
+			util_log_out(esc, 2);
+		} else if((unsigned char)*p < 0x20){
+			util_log_out(esc, snprintf(esc, sizeof(esc), "\\u%04x", *p));
+		} else {
+			util_log_out(p, 1);
+		}
+	}
+	util_log_out("\"", 1);
+}
+
+static void util_log_format(int64_t time_ms, int level, const char* mod, const char* text, size_t len){
+	char buf[128];
+
+	if(log_format == LOG_FMT_JSON){
+		util_log_out(buf, snprintf(buf, sizeof(buf), "{\"time\":%" PRId64 ",\"level\":\"%s\"", time_ms, log_level_names[level]));
+		if(*mod){
+			util_log_out(",\"module\":", 10);
+			util_log_out_json_str(mod, strlen(mod));
+		}
+		util_log_out(",\"msg\":", 7);
+		util_log_out_json_str(text, len);
+		util_log_out("}\n", 2);
+		return;
+	}
+
+	// the timestamp only changes once a second, so don't strftime for every message.
+	static time_t time_cached = -1;
+	static char   time_buf[32];
+	static size_t time_len;
+
+	time_t now = time_ms / 1000;
+	if(now != time_cached){
+		struct tm now_tm;
+		localtime_r(&now, &now_tm);
+		time_len = strftime(time_buf, sizeof(time_buf), "[%F %T] ", &now_tm);
+		time_cached = now;
+	}
+	util_log_out(time_buf, time_len);
+
+	if(level != IRC_LOG_INFO){
+		util_log_out(buf, snprintf(buf, sizeof(buf), "%s ", log_level_names[level]));
+	}
+	if(*mod){
+		util_log_out(buf, snprintf(buf, sizeof(buf), "%s: ", mod));
+	}
+	util_log_out(text, len);
+	util_log_out("\n", 1);
+}
+
+static void* util_log_thread(void* arg){
+	char   cap_buf[LOG_TEXT_MAX];
+	size_t cap_len = 0;
+
+	struct pollfd pfds[] = {
+		{ .fd = log_eventfd   , .events = POLLIN },
+		{ .fd = log_capture_fd, .events = POLLIN },
+	};
+
+	prctl(PR_SET_NAME, "ib-log");
+
+	for(;;){
+		bool quit = __atomic_load_n(&log_quit, __ATOMIC_ACQUIRE);
+
+		// stdout / stderr, split into lines
+		ssize_t n = -1;
+		while(pfds[1].fd != -1 && (n = read(log_capture_fd, cap_buf + cap_len, sizeof(cap_buf) - cap_len)) != 0){
+			if(n == -1){
+				if(errno == EINTR) continue;
+				break;
+			}
+			cap_len += n;
+
+			char *line = cap_buf, *nl;
+			while((nl = memchr(line, '\n', cap_buf + cap_len - line))){
+				util_log_format(util_log_now_ms(), IRC_LOG_INFO, "", line, nl - line);
+				line = nl + 1;
+			}
+
+			cap_len -= (line - cap_buf);
+			memmove(cap_buf, line, cap_len);
+
+			if(cap_len == sizeof(cap_buf)){
+				util_log_format(util_log_now_ms(), IRC_LOG_INFO, "", cap_buf, cap_len);
+				cap_len = 0;
+			}
+		}
+		if(n == 0){
+			pfds[1].fd = -1;
+		}
+
+		// messages from util_log_v
+		for(;;){
+			LogEntry* e = log_ring + (log_tail & (LOG_RING_SLOTS - 1));
+			if(__atomic_load_n(&e->seq, __ATOMIC_ACQUIRE) != log_tail + 1) break;
+
+			util_log_format(e->time_ms, e->level, e->mod, e->text, e->len);
+
+			__atomic_store_n(&e->seq, log_tail + LOG_RING_SLOTS, __ATOMIC_RELEASE);
+			++log_tail;
+		}
+
+		uint64_t dropped = __atomic_exchange_n(&log_dropped, 0, __ATOMIC_RELAXED);
+		if(dropped){
+			char buf[64];
+			int len = snprintf(buf, sizeof(buf), "(%" PRIu64 " log messages dropped)", dropped);
+			util_log_format(util_log_now_ms(), IRC_LOG_WARN, "", buf, len);
+		}
+
+		if(quit){
+			if(cap_len){
+				util_log_format(util_log_now_ms(), IRC_LOG_INFO, "", cap_buf, cap_len);
+			}
+			util_log_out_flush();
+			break;
+		}
+
+		util_log_out_flush();
+
+		// tell producers to wake us, then check again in case something was added before they could see that.
+		__atomic_store_n(&log_sleeping, 1, __ATOMIC_SEQ_CST);
+		__atomic_thread_fence(__ATOMIC_SEQ_CST);
+
+		LogEntry* e = log_ring + (log_tail & (LOG_RING_SLOTS - 1));
+		if(__atomic_load_n(&e->seq, __ATOMIC_ACQUIRE) != log_tail + 1){
+			if(poll(pfds, ARRAY_SIZE(pfds), -1) > 0 && (pfds[0].revents & POLLIN)){
+				uint64_t count;
+				if(read(log_eventfd, &count, sizeof(count)) == -1){
+					// EAGAIN, someone else's wakeup raced us
+				}
+			}
+		}
+
+		__atomic_store_n(&log_sleeping, 0, __ATOMIC_RELAXED);
+	}
+
+	return NULL;
+}
+
+static void util_log_init(void){
+	const char* fmt = getenv("INSOBOT_LOG_FORMAT");
+	if(fmt && strcasecmp(fmt, "json") == 0){
+		log_format = LOG_FMT_JSON;
+	}
+
+	const char* lvl = getenv("INSOBOT_LOG_LEVEL");
+	if(lvl){
+		int l = util_log_level_parse(lvl);
+		if(l == -1){
+			fprintf(stderr, "Unknown INSOBOT_LOG_LEVEL [%s], using info.\n", lvl);
+		} else {
+			log_level_core = log_level_default = l;
+		}
+	}
+
+	for(size_t i = 0; i < LOG_RING_SLOTS; ++i){
+		log_ring[i].seq = i;
+	}
+
+	int cap[2];
+	if(pipe2(cap, O_CLOEXEC) == -1){
+		perror("log_init: pipe2");
+		return;
+	}
+
+	// only the read end is non-blocking, a full pipe should still block printf rather than lose output.
+	fcntl(cap[0], F_SETFL, O_NONBLOCK);
+
+	log_out_fd     = fcntl(STDOUT_FILENO, F_DUPFD_CLOEXEC, 3);
+	log_eventfd    = eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+	log_capture_fd = cap[0];
+
+	if(log_out_fd == -1 || log_eventfd == -1 || pthread_create(&log_thread, NULL, &util_log_thread, NULL) != 0){
+		fputs("log_init: couldn't start the log thread, logging directly.\n", stderr);
+		if(log_out_fd != -1)  close(log_out_fd);
+		if(log_eventfd != -1) close(log_eventfd);
+		close(cap[0]);
+		close(cap[1]);
+		log_out_fd = log_eventfd = log_capture_fd = -1;
+		return;
+	}
+
+	fflush(stdout);
+	fflush(stderr);
+	dup2(cap[1], STDOUT_FILENO);
+	dup2(cap[1], STDERR_FILENO);
+	close(cap[1]);
+
+	setlinebuf(stdout);
+}
+
+static void util_log_quit(void){
+	if(log_eventfd == -1) return;
+
+	// point stdout / stderr back, so the log thread can read what's left in the pipe and stop.
+	fflush(stdout);
+	fflush(stderr);
+	dup2(log_out_fd, STDOUT_FILENO);
+	dup2(log_out_fd, STDERR_FILENO);
+
+	__atomic_store_n(&log_quit, true, __ATOMIC_RELEASE);
+
+	uint64_t one = 1;
+	if(write(log_eventfd, &one, sizeof(one)) == -1){
+		perror("log_quit: eventfd write");
 	}
+	pthread_join(log_thread, NULL);
 
-	fclose(f);
+	close(log_eventfd);
+	close(log_capture_fd);
+	close(log_out_fd);
+	log_eventfd = log_capture_fd = log_out_fd = -1;
 }
 
 static void util_handle_sig(int n){
 	if(n == SIGSEGV){
+		// the log thread won't get a chance to write this out, so go straight to the real stdout.
+		if(log_out_fd != -1){
+			dup2(log_out_fd, STDERR_FILENO);
+		}
+
 		void* buf[32];
 		int size = backtrace(buf, 32);
 		fputs("########## SIGSEGV BACKTRACE ##########\n", stderr);
@@ -221,6 +1153,61 @@ static void util_handle_sig(int n){
 	}
 }
 
+// the previous child might have crashed from a wild write, so nothing in the directory is trusted until it's checked
+static bool util_warm_valid(void){
+	const uint64_t data_size = WARM_SIZE - sizeof(WarmRegion);
+
+	if(warm->magic != WARM_MAGIC || warm->count > WARM_MAX_SEGMENTS || warm->used > data_size){
+		return false;
+	}
+
+	for(uint32_t i = 0; i < warm->count; ++i){
+		const WarmSegment* seg = warm->segments + i;
+
+		if(
+			!memchr(seg->name, '\0', sizeof(seg->name)) ||
+			seg->capacity > warm->used ||
+			seg->offset > warm->used - seg->capacity ||
+			seg->size > seg->capacity
+		){
+			return false;
+		}
+	}
+
+	return true;
+}
+
+// moves the segments down over any space left behind by ones that grew, keeping their order in the data
+static void util_warm_compact(void){
+	WarmSegment* order[WARM_MAX_SEGMENTS];
+
+	for(uint32_t i = 0; i < warm->count; ++i){
+		uint32_t j = i;
+		for(; j > 0 && order[j-1]->offset > warm->segments[i].offset; --j){
+			order[j] = order[j-1];
+		}
+		order[j] = warm->segments + i;
+	}
+
+	uint64_t used = 0;
+	for(uint32_t i = 0; i < warm->count; ++i){
+		WarmSegment* seg = order[i];
+		if(seg->offset != used){
+			memmove(warm->data + used, warm->data + seg->offset, seg->size);
+			seg->offset = used;
+		}
+		used += seg->capacity;
+	}
+
+	warm->used = used;
+}
+
+static void util_warm_reset(void){
+	warm->magic = WARM_MAGIC;
+	warm->count = 0;
+	warm->used  = 0;
+}
+
 static void util_multiprocess_init(void){
 
 	if(getenv("INSOBOT_DEBUG_CHAN")){
@@ -230,7 +1217,19 @@ static void util_multiprocess_init(void){
 		}
 	}
 
-restart:
+	warm = mmap(NULL, WARM_SIZE, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+	if(warm == MAP_FAILED){
+		perror("warm restart mmap failed");
+		warm = NULL;
+	} else {
+		util_warm_reset();
+	}
+
+	int quick_crashes = 0;
+
+restart:;
+	time_t started = time(0);
+
 	if(pipe(pipe_fds) == -1){
 		perror("pipe failed");
 		exit(1);
@@ -278,6 +1277,13 @@ restart:
 		}
 
 		if(!getenv("INSOBOT_NO_AUTO_RESTART") && exitnum != 0){
+			// if it keeps crashing straight away, the saved state might be why
+			quick_crashes = (time(0) - started < WARM_QUICK_CRASH) ? quick_crashes + 1 : 0;
+			if(warm && quick_crashes >= 2){
+				puts("Crashed quickly twice in a row, throwing away the warm restart state.");
+				util_warm_reset();
+			}
+
 			puts("Gonna try to auto restart...");
 			signal(SIGINT , SIG_DFL);
 			if(usleep(5000000) == -1){
@@ -300,6 +1306,21 @@ restart:
 
 	setlinebuf(stdout);
 	setlinebuf(stderr);
+
+	if(warm){
+		if(util_warm_valid()){
+			util_warm_compact();
+		} else {
+			puts("The warm restart state is corrupt, throwing it away.");
+			util_warm_reset();
+		}
+	}
+}
+
+static int64_t util_mono_ms(void){
+	struct timespec ts = {};
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (ts.tv_sec * 1000) + (ts.tv_nsec / 1000000);
 }
 
 static inline const char* util_env_else(const char* env, const char* def){
@@ -307,1062 +1328,4255 @@ static inline const char* util_env_else(const char* env, const char* def){
 	return c ? c : def;
 }
 
-static bool util_check_perms(const char* mod, const char* chan, int id){
-	bool ret = true;
-	for(Module* m = irc_modules; m < sb_end(irc_modules); ++m){
-		if(!m->ctx->on_meta) continue;
-		ret &= IRC_MOD_CALL(m, on_meta, (mod, chan, id));
+// RFC1459 casemapping: []\~ are the uppercase versions of {}|^
+static inline char util_irc_tolower(char c){
+	switch(c){
+		case '[':  return '{';
+		case ']':  return '}';
+		case '\\': return '|';
+		case '~':  return '^';
+		default:   return (c >= 'A' && c <= 'Z') ? c + ('a' - 'A') : c;
 	}
-	return ret;
 }
 
-static void util_dispatch_cmds(Module* m, const char* chan, const char* name, const char* msg){
-	if(!m->ctx || !m->ctx->commands || !m->ctx->on_cmd) return;
-
-	for(const char** cmd_list = m->ctx->commands; *cmd_list; ++cmd_list){
-		const char *cmd = *cmd_list, *cmd_end;
+static uint32_t util_irc_hash(const char* name){
+	uint32_t hash = 2166136261u;
+	for(; *name; ++name){
+		hash ^= (uint8_t)util_irc_tolower(*name);
+		hash *= 16777619u;
+	}
+	return hash;
+}
 
-		do {
-			cmd_end = strchrnul(cmd, ' ');
-			const size_t sz = cmd_end - cmd;
+static bool util_irc_streq(const char* a, const char* b){
+	while(*a && util_irc_tolower(*a) == util_irc_tolower(*b)){
+		++a, ++b;
+	}
+	return util_irc_tolower(*a) == util_irc_tolower(*b);
+}
 
-			if(strncasecmp(msg, cmd, sz) == 0 && (msg[sz] == ' ' || msg[sz] == '\0')){
-				IRC_MOD_CALL(m, on_cmd, (chan, name, msg + sz, cmd_list - m->ctx->commands));
-				break;
-			}
+// chan == NULL clears the cache for every channel
+static void util_perm_cache_clear(const char* chan){
+	for(PermCache* pc = perm_cache; pc < sb_end(perm_cache); ++pc){
+		if(chan && !util_irc_streq(pc->chan, chan)) continue;
 
-			while(*cmd_end == ' ') ++cmd_end;
-			cmd = cmd_end;
-		} while(*cmd_end);
+		free(pc->chan);
+		free(pc->known);
+		free(pc->enabled);
+		sb_erase(perm_cache, pc - perm_cache);
+		--pc;
 	}
+
+	perm_batch_index = -1;
 }
 
-static size_t util_cmd_enqueue(int cmd, const char* chan, const char* data){
-	if(sb_count(cmd_queue) > CMD_QUEUE_MAX) return 0;
+static PermCache* util_perm_cache_get(const char* chan){
+	if(chan == perm_batch_chan && perm_batch_index != -1){
+		return perm_cache + perm_batch_index;
+	}
 
-	size_t id = ++last_cmd_id;
-	if(!id) ++id;
+	for(PermCache* pc = perm_cache; pc < sb_end(perm_cache); ++pc){
+		if(util_irc_streq(pc->chan, chan)){
+			if(chan == perm_batch_chan) perm_batch_index = pc - perm_cache;
+			return pc;
+		}
+	}
 
-	IRCCmd c = {
-		.id   = id,
-		.cmd  = cmd,
-		.chan = chan ? strdup(chan) : NULL,
-		.data = data ? strdup(data) : NULL
+	PermCache pc = {
+		.chan    = strdup(chan),
+		.known   = calloc(PERM_CB_COUNT * perm_cache_words, sizeof(uint64_t)),
+		.enabled = calloc(PERM_CB_COUNT * perm_cache_words, sizeof(uint64_t)),
 	};
+	sb_push(perm_cache, pc);
 
-	sb_push(cmd_queue, c);
+	if(chan == perm_batch_chan){
+		perm_batch_index = sb_count(perm_cache) - 1;
+	}
 
-	return c.id;
+	return &sb_last(perm_cache);
 }
 
-static void util_process_pending_cmds(void){
-	if(!sb_count(cmd_queue)) return;
-
-	struct timespec ts = {};
-	clock_gettime(CLOCK_MONOTONIC, &ts);
-	uint32_t cmd_ms = (ts.tv_sec * 1000) + (ts.tv_nsec / 1000000);
+static void util_mod_subs_build(void){
+	const size_t first_cb = MOD_CB_SLOT(on_init);
 
-	if((cmd_ms - prev_cmd_ms) > CMD_RATE_LIMIT_MS){
-		prev_cmd_ms = cmd_ms;
+	for(size_t i = 0; i < MOD_CB_COUNT; ++i){
+		while(sb_count(mod_subs[i]) > 0) sb_pop(mod_subs[i]);
+	}
 
-		IRCCmd cmd = cmd_queue[0];
-		switch(cmd.cmd){
+	for(Module* m = irc_modules; m < sb_end(irc_modules); ++m){
+		if(!m->lib_handle || !m->ctx || m->init_state != MOD_INIT_READY) continue;
 
-			case IRC_CMD_JOIN: {
-				irc_cmd_join(irc_ctx, cmd.chan, cmd.data);
-//				irc_on_join(irc_ctx, "join", cmd.data, (const char**)&cmd.chan, 1);
-			} break;
+		// modules built against an older IRCModuleCtx don't have the newer callbacks at all
+		const size_t num_cbs = INSO_MIN(m->ctx_size / sizeof(void*), MOD_CB_COUNT);
 
-			case IRC_CMD_PART: {
-				irc_cmd_part(irc_ctx, cmd.chan);
-//				irc_on_part(irc_ctx, "part", cmd.data, (const char**)&cmd.chan, 1);
-			} break;
+		for(size_t i = first_cb; i < num_cbs; ++i){
+			void* fn;
+			memcpy(&fn, (char*)m->ctx + i * sizeof(void*), sizeof(fn));
+			if(fn) sb_push(mod_subs[i], m);
+		}
+	}
 
-			case IRC_CMD_MSG: {
-				size_t len = strlen(cmd.data);
-				IRC_MOD_CALL_ALL_ABI(on_filter, (cmd.id, cmd.chan, cmd.data, len), ABI_FILTER);
-				if(*cmd.data){
-					printf("send: [%s] [%s]\n", cmd.chan, cmd.data);
-					irc_cmd_msg(irc_ctx, cmd.chan, cmd.data);
-					IRC_MOD_CALL_ALL(on_msg_out, (cmd.chan, cmd.data));
-				}
-			} break;
+	mod_subs_dirty = false;
 
-			case IRC_CMD_RAW: {
-				size_t len = strlen(cmd.data);
-				IRC_MOD_CALL_ALL_ABI(on_filter, (cmd.id, NULL, cmd.data, len), ABI_FILTER);
-				if(*cmd.data){
-					irc_send_raw(irc_ctx, "%s", cmd.data);
-				}
-			} break;
-		}
+	// module indices may have changed
+	util_perm_cache_clear(NULL);
+	perm_cache_words = (sb_count(irc_modules) + 63) / 64 + 1;
+}
 
-		if(cmd.chan) free(cmd.chan);
-		if(cmd.data) free(cmd.data);
-		sb_erase(cmd_queue, 0);
+static Module** util_mod_subs(size_t slot){
+	if(mod_subs_dirty){
+		util_mod_subs_build();
 	}
+	return mod_subs[slot];
 }
 
-static void util_module_add(const char* name){
-	char path_buf[PATH_MAX];
-	const char* path = name;
-
-	if(!strchr(path, '/')){
-		if(strlen(inotify.module.path) + strlen(name) + 1 > sizeof(path_buf)) return;
+static bool util_check_perms(Module* m, const char* chan, int id){
+	Module** subs = util_mod_subs(MOD_CB_SLOT(on_meta));
 
-		strcpy(path_buf, inotify.module.path);
-		strcat(path_buf, name);
-		path = path_buf;
+	if(!chan || id < 0 || id >= PERM_CB_COUNT){
+		bool ret = true;
+		for(Module** sub = subs; sub < sb_end(subs); ++sub){
+			ret &= IRC_MOD_CALL(*sub, on_meta, (m->ctx->name, chan, id));
+		}
+		return ret;
 	}
 
-	Module m = {
-		.lib_path = strdup(path),
-		.needs_reload = true
-	};
+	PermCache* pc = util_perm_cache_get(chan);
 
-	sb_push(irc_modules, m);
-}
+	const size_t   mod  = m - irc_modules;
+	const size_t   word = id * perm_cache_words + mod / 64;
+	const uint64_t bit  = 1ULL << (mod % 64);
 
-static void util_module_save(Module* m){
-	if(!m->ctx || !m->ctx->on_save) return;
-
-	// change the inotify data watch to something we don't care about to disable it temporarily
-	inotify.data.wd = inotify_add_watch(inotify.fd, inotify.data.path, IN_DELETE_SELF);
-
-	sb_push(mod_call_stack, m);
-
-	const char*  save_fname = core_get_datafile();
-	const size_t save_fsz   = strlen(save_fname);
-	const char   tmp_end[]  = ".XXXXXX";
-	char*        tmp_fname  = alloca(save_fsz + sizeof(tmp_end));
-
-	memcpy(tmp_fname, save_fname, save_fsz);
-	memcpy(tmp_fname + save_fsz, tmp_end, sizeof(tmp_end));
+	if(!(pc->known[word] & bit)){
+		bool ret = true;
+		for(Module** sub = subs; sub < sb_end(subs); ++sub){
+			ret &= IRC_MOD_CALL(*sub, on_meta, (m->ctx->name, chan, id));
+		}
 
-	int tmp_fd = mkstemp(tmp_fname);
-	if(tmp_fd < 0){
-		fprintf(stderr, "Error saving file for %s: %s\n", m->ctx->name, strerror(errno));
-	} else {
-		FILE* tmp_file = fdopen(tmp_fd, "wb");
-		bool saved = m->ctx->on_save(tmp_file);
-		fclose(tmp_file);
+		// on_meta might have called perms_changed, which would free pc
+		pc = util_perm_cache_get(chan);
 
-		if(saved && rename(tmp_fname, save_fname) < 0){
-			fprintf(stderr, "Error saving file for %s: %s\n", m->ctx->name, strerror(errno));
-		} else if(!saved){
-			unlink(tmp_fname);
+		pc->known[word] |= bit;
+		if(ret){
+			pc->enabled[word] |= bit;
 		}
 	}
 
-	sb_pop(mod_call_stack);
-
-	inotify.data.wd = inotify_add_watch(inotify.fd, inotify.data.path, IN_CLOSE_WRITE | IN_MOVED_TO);
+	return pc->enabled[word] & bit;
 }
 
-static Module* util_module_get(const char* name, int type){
+static Module* util_module_from_ctx(const IRCModuleCtx* ctx){
 	for(Module* m = irc_modules; m < sb_end(irc_modules); ++m){
-		const char* base_path = basename(m->lib_path);
-		const char* comparison
-			= (type == MOD_GET_CTXNAME)	? m->ctx->name
-			: (type == MOD_GET_SONAME)  ? base_path
-			: NULL;
-
-		if(strcmp(name, comparison) == 0){
-			return m;
-		}
+		if(m->ctx == ctx) return m;
 	}
 	return NULL;
 }
 
-static int util_mod_sort(const void* a, const void* b){
-	return ((Module*)b)->ctx->priority - ((Module*)a)->ctx->priority;
+static IRCFdWatch* util_fd_find(int fd){
+	for(IRCFdWatch* w = fd_watches; w < sb_end(fd_watches); ++w){
+		if(w->fd == fd) return w;
+	}
+	return NULL;
 }
 
-static void util_reload_modules(const IRCCoreCtx* core_ctx){
-
-	for(Module* m = irc_modules; m < sb_end(irc_modules); ++m){
-		if(!m->needs_reload) continue;
-		mod_list_dirty = true;
-
-		const char* mod_name = basename(m->lib_path);
+static void util_fd_watch(int fd, int events, IRCModuleCtx* owner, IRCFdCallback cb, void* arg){
+	IRCFdWatch* w = util_fd_find(fd);
 
-		if(m->lib_handle){
-			util_module_save(m);
-			IRC_MOD_CALL(m, on_quit, ());
-			dlclose(m->lib_handle);
+	if(!events || !cb){
+		if(w){
+			epoll_ctl(epoll_fd, EPOLL_CTL_DEL, fd, NULL);
+			sb_erase(fd_watches, w - fd_watches);
 		}
+		return;
+	}
 
-		dlerror();
-		m->lib_handle = dlopen(m->lib_path, RTLD_LAZY | RTLD_LOCAL);
-
-		printf("Loading module %-20s", mod_name);
+	struct epoll_event ev = {
+		.events  = ((events & IRC_FD_READ) ? EPOLLIN : 0) | ((events & IRC_FD_WRITE) ? EPOLLOUT : 0),
+		.data.fd = fd,
+	};
 
-		const char* errmsg = dlerror();
-		if(!errmsg && m->lib_handle){
-			m->ctx = dlsym(m->lib_handle, "irc_mod_ctx");
-			errmsg = dlerror();
-		} else if(!errmsg && !m->lib_handle){
-			errmsg = "NULL lib handle.";
-		}
+	int ret = epoll_ctl(epoll_fd, w ? EPOLL_CTL_MOD : EPOLL_CTL_ADD, fd, &ev);
 
-		if(!errmsg){
-			const ElfW(Sym)* sym = NULL;
-			Dl_info unused;
-			if(dladdr1(m->ctx, &unused, (void**)&sym, RTLD_DL_SYMENT) == 0){
-				errmsg = "dladdr1 failed.";
-			} else if(sym->st_size < (sizeof(void*)*23)) {
-				
-				// NOTE: ABI Table for IRCModuleCtx:
-				//
-				//       | sizeof(void*) | last field |
-				//       +---------------+------------+
-				//       |      x23      | on_ipc     |
-				//       |      x24      | on_filter  |
-				//       |      x25      | on_unknown |
+	// the fd might have been closed and reused without being removed first
+	if(ret == -1 && errno == ENOENT){
+		ret = epoll_ctl(epoll_fd, EPOLL_CTL_ADD, fd, &ev);
+	} else if(ret == -1 && errno == EEXIST){
+		ret = epoll_ctl(epoll_fd, EPOLL_CTL_MOD, fd, &ev);
+	}
 
-				errmsg = "version mismatch (wrong size irc_mod_ctx)";
-			} else {
-				m->ctx_size = sym->st_size;
-			}
+	if(ret == -1){
+		fprintf(stderr, "Can't watch fd %d: %s\n", fd, strerror(errno));
+		if(w){
+			sb_erase(fd_watches, w - fd_watches);
 		}
+		return;
+	}
 
-		if(errmsg){
-			puts("");
-			fprintf(stderr, "** Error loading module %s:\n  %s\n", mod_name, errmsg);
-			if(m->lib_handle){
-				dlclose(m->lib_handle);
-				m->lib_handle = NULL;
-			}
-			free(m->lib_path);
-			sb_erase(irc_modules, m - irc_modules);
-			--m;
-			continue;
-		} else {
-			struct link_map* mod_info = m->lib_handle;
-			printf("[0x%zx]\n", (size_t)mod_info->l_addr);
-		}
+	if(!w){
+		sb_push(fd_watches, (IRCFdWatch){ .fd = fd });
+		w = &sb_last(fd_watches);
 	}
 
-	for(Module* m = irc_modules; m < sb_end(irc_modules); ++m){
-		if(!m->needs_reload) continue;
-		m->needs_reload = false;
+	w->events = events;
+	w->owner  = owner;
+	w->cb     = cb;
+	w->arg    = arg;
+}
 
-		const char* mod_name = basename(m->lib_path);
-		printf("Init %s...\n", mod_name);
+static void util_fd_unwatch_all(const IRCModuleCtx* owner){
+	for(IRCFdWatch* w = fd_watches; w < sb_end(fd_watches); ++w){
+		if(w->owner != owner) continue;
 
-		if(!IRC_MOD_CALL(m, on_init, (core_ctx))){
-			printf("** Init failed for %s.\n", mod_name);
-			dlclose(m->lib_handle);
-			m->lib_handle = NULL;
-			free(m->lib_path);
-			sb_erase(irc_modules, m - irc_modules);
-			--m;
-			continue;
-		}
+		epoll_ctl(epoll_fd, EPOLL_CTL_DEL, w->fd, NULL);
+		sb_erase(fd_watches, w - fd_watches);
+		--w;
+	}
+}
 
-		if(irc_ctx && irc_is_connected(irc_ctx)){
-			IRC_MOD_CALL(m, on_connect, (serv));
-		}
+static void util_fd_dispatch(int fd, uint32_t ep_events){
+	IRCFdWatch* w = util_fd_find(fd);
+	if(!w) return;
 
-		for(size_t i = 0; i < sb_count(channels) - 1; ++i){
-			const char** c = (const char**)channels + i;
+	// copy it since the callback is allowed to change fd_watches
+	IRCFdWatch watch = *w;
 
-			IRC_MOD_CALL(m, on_join, (*c, bot_nick));
-			for(size_t j = 0; j < sb_count(chan_nicks[i]); ++j){
-				IRC_MOD_CALL(m, on_join, (*c, chan_nicks[i][j]));
-			}
-		}
+	int events = 0;
+	if(ep_events & EPOLLIN)               events |= IRC_FD_READ;
+	if(ep_events & EPOLLOUT)              events |= IRC_FD_WRITE;
+	if(ep_events & (EPOLLERR | EPOLLHUP)) events |= IRC_FD_ERROR;
+
+	Module* m = NULL;
+	if(watch.owner && !(m = util_module_from_ctx(watch.owner))){
+		return;
 	}
 
-	qsort(irc_modules, sb_count(irc_modules), sizeof(*irc_modules), &util_mod_sort);
+	if(m) sb_push(mod_call_stack, m);
+	const int64_t start = util_stats_now();
+	watch.cb(fd, events, watch.arg);
+	util_stats_record(m, MOD_STAT_FD, start);
+	if(m) sb_pop(mod_call_stack);
 }
 
-static void util_inotify_add(INotifyWatch* watch, const char* path, uint32_t flags){
+static size_t util_http_write_cb(char* ptr, size_t sz, size_t nmemb, void* arg){
+	IRCHTTPReq* req = arg;
+	const size_t total = sz * nmemb;
 
-	if(access(path, W_OK) != 0){
-		printf("Creating dir [%s] for inotify.\n", path);
-		if(mkdir(path, 00750) == -1){
-			perror("Error creating dir");
-		}
-	}
+	memcpy(sb_add(req->data, total), ptr, total);
 
-	watch->path = strdup(path);
-	watch->wd   = inotify_add_watch(inotify.fd, path, flags);
+	return total;
 }
 
-static void util_inotify_check(const IRCCoreCtx* core_ctx){
-	struct inotify_event* ev;
-	char buff[sizeof(*ev) + NAME_MAX + 1];
-	bool reload = false;
-
-	ssize_t num_read = read(inotify.fd, &buff, sizeof(buff));
+static void util_http_fd_cb(int fd, int events, void* arg);
 
-	for(char* p = buff; (p - buff) < num_read; p += (sizeof(*ev) + ev->len)){
-		ev = (struct inotify_event*)p;
+static int util_http_sock_cb(CURL* curl, curl_socket_t sock, int what, void* userp, void* sockp){
+	int events = 0;
 
-		if(ev->wd == inotify.module.wd){
-			Module* m = util_module_get(ev->name, MOD_GET_SONAME);
-			if(m){
-				m->needs_reload = true;
-			} else {
-				util_module_add(ev->name);
-			}
-			reload = true;
-		} else if(ev->wd == inotify.data.wd){
-			if(!memmem(ev->name, ev->len, ".data", 6)) continue;
-			fprintf(stderr, "%s was modified.\n", ev->name);
+	if(what == CURL_POLL_IN  || what == CURL_POLL_INOUT) events |= IRC_FD_READ;
+	if(what == CURL_POLL_OUT || what == CURL_POLL_INOUT) events |= IRC_FD_WRITE;
 
-			Module* m = util_module_get(strndupa(ev->name, strlen(ev->name) - 5), MOD_GET_CTXNAME);
-			if(m){
-				m->data_modified = true;
-			}
-		} else if(ev->wd == inotify.ipc.wd){
-			struct sockaddr_un addr;
+	// events == 0 for CURL_POLL_REMOVE, which unwatches it
+	util_fd_watch(sock, events, NULL, &util_http_fd_cb, NULL);
 
-			assert(strlen(ev->name) + strlen(inotify.ipc.path) + 1 < sizeof(addr.sun_path));
+	return 0;
+}
 
-			strcpy(addr.sun_path, inotify.ipc.path);
-			strcat(addr.sun_path, ev->name);
+static int util_http_timer_cb(CURLM* multi, long timeout_ms, void* userp){
+	http_timeout_ms = timeout_ms < 0 ? -1 : util_mono_ms() + timeout_ms;
+	return 0;
+}
 
-			if(ev->mask & IN_DELETE){
-				util_ipc_del(addr.sun_path);
-			} else {
-				util_ipc_add(addr.sun_path);
-			}
+static void util_http_free(IRCHTTPReq* req){
+	for(IRCHTTPReq** r = http_reqs; r < sb_end(http_reqs); ++r){
+		if(*r == req){
+			sb_erase(http_reqs, r - http_reqs);
+			break;
 		}
 	}
 
-	for(Module* m = irc_modules; m < sb_end(irc_modules); ++m){
-		if(!m->data_modified) continue;
-		m->data_modified = false;
-
-		fprintf(stderr, "Calling on_data_modified for %s\n", m->ctx->name);
-		IRC_MOD_CALL(m, on_modified, ());
-	}
-
-	if(reload){
-		util_reload_modules(core_ctx);
-	}
+	curl_multi_remove_handle(curl_multi, req->curl);
+	curl_easy_cleanup(req->curl);
+	curl_slist_free_all(req->headers);
+	sb_free(req->data);
+	free(req);
 }
 
-static void util_ipc_init(void){
-	char ipc_dir[128];
-	struct stat st;
+static void util_http_check_done(void){
+	CURLMsg* msg;
+	int remaining;
 
-	// get dir to store ipc sockets
+	while((msg = curl_multi_info_read(curl_multi, &remaining))){
+		if(msg->msg != CURLMSG_DONE) continue;
 
-	const char* ipc_dir_prefix   = getenv("XDG_RUNTIME_DIR");
-	const char  ipc_dir_suffix[] = "/insobot/";
+		IRCHTTPReq* req = NULL;
+		CURLcode curl_ret = msg->data.result;
+		curl_easy_getinfo(msg->easy_handle, CURLINFO_PRIVATE, (char**)&req);
+		assert(req);
 
-	if(!ipc_dir_prefix || stat(ipc_dir_prefix, &st) == -1 || !S_ISDIR(st.st_mode) || access(ipc_dir_prefix, W_OK) == -1){
-		ipc_dir_prefix = "/run/shm";
-	}
+		// msg is invalidated by this
+		curl_multi_remove_handle(curl_multi, req->curl);
 
-	if(strlen(ipc_dir_prefix) + sizeof(ipc_dir_suffix) + 8 > sizeof(ipc_self.addr.sun_path)){
-		fprintf(stderr, "IPC dir name too long!");
-		return;
-	}
+		IRCHTTPResult res = {
+			.data_len = sb_count(req->data),
+			.curl     = req->curl,
+		};
 
-	strcpy(ipc_dir, ipc_dir_prefix);
-	strcat(ipc_dir, ipc_dir_suffix);
+		sb_push(req->data, 0);
+		res.data = req->data;
 
-	if(stat(ipc_dir, &st) == -1){
-		if(mkdir(ipc_dir, 0777) == -1){
-			perror("ipc_init: mkdir");
+		if(curl_ret != CURLE_OK){
+			res.status = -curl_ret;
+		} else {
+			curl_easy_getinfo(req->curl, CURLINFO_RESPONSE_CODE, &res.status);
 		}
-	}
 
-	// create our socket
+		Module* m = util_module_from_ctx(req->owner);
+		if(m || !req->owner){
+			if(m) sb_push(mod_call_stack, m);
+			const int64_t start = util_stats_now();
+			req->cb(&res, req->arg);
+			util_stats_record(m, MOD_STAT_HTTP, start);
+			if(m) sb_pop(mod_call_stack);
+		}
 
-	ipc_self.id = getpid();
-	ipc_self.addr.sun_family = AF_UNIX;
+		util_http_free(req);
+	}
+}
 
-	snprintf(ipc_self.addr.sun_path, sizeof(ipc_self.addr.sun_path), "%s%d", ipc_dir, ipc_self.id);
-	unlink(ipc_self.addr.sun_path);
+static void util_http_fd_cb(int fd, int events, void* arg){
+	int mask = 0, running_handles;
 
-	printf("IPC socket: %s\n", ipc_self.addr.sun_path);
+	if(events & IRC_FD_READ)  mask |= CURL_CSELECT_IN;
+	if(events & IRC_FD_WRITE) mask |= CURL_CSELECT_OUT;
+	if(events & IRC_FD_ERROR) mask |= CURL_CSELECT_ERR;
 
-	ipc_socket = socket(AF_UNIX, SOCK_DGRAM, 0);
-	if(ipc_socket == -1){
-		perror("ipc_init: socket");
-	}
+	curl_multi_socket_action(curl_multi, fd, mask, &running_handles);
+	util_http_check_done();
+}
 
-	if(bind(ipc_socket, &ipc_self.addr, sizeof(ipc_self.addr)) == -1){
-		perror("ipc_init: bind");
-	}
+static void util_http_tick(void){
+	if(http_timeout_ms == -1 || util_mono_ms() < http_timeout_ms) return;
 
-	// get all the peer addresses in the dir
+	int running_handles;
+	http_timeout_ms = -1;
 
-	util_inotify_add(&inotify.ipc, ipc_dir, IN_CREATE | IN_DELETE | IN_MOVED_TO);
+	curl_multi_socket_action(curl_multi, CURL_SOCKET_TIMEOUT, 0, &running_handles);
+	util_http_check_done();
+}
 
-	strcat(ipc_dir, "*");
+// calls the callbacks with an error first, so that the module can free their args
+static void util_http_cancel_all(const IRCModuleCtx* owner){
+	Module* m = util_module_from_ctx(owner);
 
-	glob_t glob_data;
-	if(glob(ipc_dir, 0, NULL, &glob_data) != 0){
-		perror("ipc_init: glob");
-	} else {
-		for(size_t i = 0; i < glob_data.gl_pathc; ++i){
-			if(strcmp(ipc_self.addr.sun_path, glob_data.gl_pathv[i]) == 0) continue;
+	for(size_t i = 0; i < sb_count(http_reqs); ++i){
+		IRCHTTPReq* req = http_reqs[i];
+		if(req->owner != owner) continue;
 
-			IPCAddress peer = {
-				.id   = atoi(basename(glob_data.gl_pathv[i])),
-				.addr = { .sun_family = AF_UNIX }
+		if(m){
+			IRCHTTPResult res = {
+				.status = -CURLE_ABORTED_BY_CALLBACK,
+				.data   = (char[]){ "" },
+				.curl   = req->curl,
 			};
 
-			printf("ipc_init: adding peer %d [%s]\n", peer.id, glob_data.gl_pathv[i]);
-
-			strcpy(peer.addr.sun_path, glob_data.gl_pathv[i]);
-			sb_push(ipc_peers, peer);
+			sb_push(mod_call_stack, m);
+			mod_cancelling = true;
+			req->cb(&res, req->arg);
+			mod_cancelling = false;
+			sb_pop(mod_call_stack);
 		}
 
-		globfree(&glob_data);
+		util_http_free(req);
+		--i;
 	}
+}
 
-	// check for stale peers
+static void util_async_push(IRCAsyncQueue* q, IRCAsyncJob* job){
+	job->next = NULL;
+	if(q->tail){
+		q->tail->next = job;
+	} else {
+		q->head = job;
+	}
+	q->tail = job;
+}
 
-	for(IPCAddress* p = ipc_peers; p < sb_end(ipc_peers); ++p){
-		if(connect(ipc_socket, &p->addr, sizeof(p->addr)) == -1){
-			if(errno == ECONNREFUSED){
-				unlink(p->addr.sun_path);
-			}
-			sb_erase(ipc_peers, p - ipc_peers);
-			--p;
-		} else {
-			struct sockaddr sa = { .sa_family = AF_UNSPEC };
-			connect(ipc_socket, &sa, sizeof(sa));
-		}
+static IRCAsyncJob* util_async_pop(IRCAsyncQueue* q){
+	IRCAsyncJob* job = q->head;
+	if(job && !(q->head = job->next)){
+		q->tail = NULL;
 	}
+	return job;
 }
 
-static IPCAddress* util_ipc_add(const char* name){
-	for(size_t i = 0; i < sb_count(ipc_peers); ++i){
-		if(strcmp(ipc_peers[i].addr.sun_path, name) == 0){
-			return ipc_peers + i;
-		}
+// moves all the jobs in q owned by owner onto removed. async_mutex must be held.
+static void util_async_remove(IRCAsyncQueue* q, const IRCModuleCtx* owner, IRCAsyncQueue* removed){
+	IRCAsyncQueue keep = {};
+	IRCAsyncJob* job;
+
+	while((job = util_async_pop(q))){
+		util_async_push(job->owner == owner ? removed : &keep, job);
 	}
 
-	IPCAddress peer = {
-		.id   = atoi(basename(name)),
-		.addr = {
-			.sun_family = AF_UNIX
+	*q = keep;
+}
+
+static void* util_async_worker(void* arg){
+	const intptr_t id = (intptr_t)arg;
+
+	pthread_mutex_lock(&async_mutex);
+
+	while(true){
+		while(!async_quit && !async_pending.head){
+			pthread_cond_wait(&async_work_cond, &async_mutex);
 		}
-	};
 
-	strcpy(peer.addr.sun_path, name);
-	sb_push(ipc_peers, peer);
+		if(async_quit) break;
+
+		IRCAsyncJob* job = util_async_pop(&async_pending);
+		async_running[id] = job;
+		pthread_mutex_unlock(&async_mutex);
+
+		job->work(job->arg);
+
+		pthread_mutex_lock(&async_mutex);
+		async_running[id] = NULL;
+		util_async_push(&async_done, job);
+		pthread_cond_broadcast(&async_idle_cond);
 
-	printf("ipc_add: %d: [%s]\n", peer.id, peer.addr.sun_path);
+		uint64_t one = 1;
+		if(write(async_eventfd, &one, sizeof(one)) == -1 && errno != EAGAIN){
+			perror("async: eventfd write");
+		}
+	}
 
-	return &sb_last(ipc_peers);
+	pthread_mutex_unlock(&async_mutex);
+
+	return NULL;
 }
 
-static void util_ipc_del(const char* name){
-	for(size_t i = 0; i < sb_count(ipc_peers); ++i){
-		if(strcmp(ipc_peers[i].addr.sun_path, name) == 0){
-			sb_erase(ipc_peers, i);
-			break;
+static void util_async_fd_cb(int fd, int events, void* arg){
+	uint64_t count;
+	if(read(fd, &count, sizeof(count)) == -1 && errno != EAGAIN){
+		perror("async: eventfd read");
+	}
+
+	pthread_mutex_lock(&async_mutex);
+	IRCAsyncQueue finished = async_done;
+	async_done = (IRCAsyncQueue){};
+	pthread_mutex_unlock(&async_mutex);
+
+	IRCAsyncJob* job;
+	while((job = util_async_pop(&finished))){
+		Module* m = util_module_from_ctx(job->owner);
+
+		if(job->done && (m || !job->owner)){
+			if(m) sb_push(mod_call_stack, m);
+			const int64_t start = util_stats_now();
+			job->done(job->arg);
+			util_stats_record(m, MOD_STAT_ASYNC, start);
+			if(m) sb_pop(mod_call_stack);
 		}
+
+		free(job);
 	}
 }
 
-static void util_ipc_recv(void){
-	char buffer[4096];
-	struct sockaddr_un addr;
-	socklen_t addr_len = sizeof(addr);
+static bool util_async_init(void){
+	if(async_num_threads) return true;
 
-	ssize_t num = recvfrom(ipc_socket, buffer, sizeof(buffer), 0, &addr, &addr_len);
-	if(num == -1){
-		perror("ipc_recv: recvfrom");
-		return;
+	if((async_eventfd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC)) == -1){
+		perror("async: eventfd");
+		return false;
 	}
 
-	assert(addr.sun_family == AF_UNIX);
+	util_fd_watch(async_eventfd, IRC_FD_READ, NULL, &util_async_fd_cb, NULL);
 
-	IPCAddress* peer = util_ipc_add(addr.sun_path);
+	long nprocs = sysconf(_SC_NPROCESSORS_ONLN);
+	int wanted = INSO_MIN(INSO_MAX(nprocs, 2L), (long)ASYNC_THREADS_MAX);
 
-	for(Module* m = irc_modules; m < sb_end(irc_modules); ++m){
-		if(strncmp(buffer, m->ctx->name, num) == 0){
-			printf("Got IPC msg from %d for %s\n", peer->id, m->ctx->name);
-			const size_t off = strlen(m->ctx->name) + 1;
-			IRC_MOD_CALL(m, on_ipc, (peer->id, (uint8_t*)(buffer + off), num - off));
+	// signals should only be handled by the main thread so they can interrupt epoll_wait
+	sigset_t all_sigs, old_sigs;
+	sigfillset(&all_sigs);
+	pthread_sigmask(SIG_SETMASK, &all_sigs, &old_sigs);
+
+	for(intptr_t i = 0; i < wanted; ++i){
+		if(pthread_create(async_threads + i, NULL, &util_async_worker, (void*)i) != 0){
+			perror("async: pthread_create");
+			break;
 		}
+		++async_num_threads;
 	}
-}
 
-static void util_find_chan_nick(const char* chan, const char* nick, int* chan_idx, int* nick_idx){
+	pthread_sigmask(SIG_SETMASK, &old_sigs, NULL);
+
+	printf("Started %d async worker threads.\n", async_num_threads);
 
-	if(chan_idx) *chan_idx = -1;
-	if(nick_idx) *nick_idx = -1;
+	return async_num_threads > 0;
+}
+
+static void util_async_cancel_all(const IRCModuleCtx* owner){
+	if(!async_num_threads) return;
 
-	for(size_t i = 0; i < sb_count(channels) - 1; ++i){
-		if(strcasecmp(channels[i], chan) != 0) continue;
+	IRCAsyncQueue removed = {};
+	pthread_mutex_lock(&async_mutex);
 
-		if(chan_idx) *chan_idx = i;
+	util_async_remove(&async_pending, owner, &removed);
 
-		for(size_t j = 0; j < sb_count(chan_nicks[i]); ++j){
-			if(strcasecmp(chan_nicks[i][j], nick) == 0){
-				if(nick_idx) *nick_idx = j;
+	// the work functions live in the module's code, so wait for them before it gets dlclose'd
+	while(true){
+		bool busy = false;
+		for(int i = 0; i < async_num_threads; ++i){
+			if(async_running[i] && async_running[i]->owner == owner){
+				busy = true;
 				break;
 			}
 		}
 
-		break;
+		if(!busy) break;
+		pthread_cond_wait(&async_idle_cond, &async_mutex);
 	}
-}
 
-static void util_trim_end_spaces(char* msg, size_t len){
-	if(len > 0){
-		for(char* p = msg + len - 1; p >= msg && *p == ' '; --p){
-			*p = 0;
+	util_async_remove(&async_done, owner, &removed);
+
+	pthread_mutex_unlock(&async_mutex);
+
+	// done is called for the module's own jobs so it can free their args, whether work ran or not
+	Module* m = util_module_from_ctx(owner);
+	IRCAsyncJob* job;
+
+	while((job = util_async_pop(&removed))){
+		if(m && job->done && job->cancel_done){
+			sb_push(mod_call_stack, m);
+			mod_cancelling = true;
+			job->done(job->arg);
+			mod_cancelling = false;
+			sb_pop(mod_call_stack);
 		}
+		free(job);
 	}
 }
 
-static void util_update_tags(const char** params){
-	if(!have_tag_hack) return;
-	strncpy(irc_tag_buf, params[-1], sizeof(irc_tag_buf)-1);
+static void util_async_quit(void){
+	if(!async_num_threads) return;
 
-	if(irc_tag_ptrs){
-		stb__sbn(irc_tag_ptrs) = 0;
-	}
+	pthread_mutex_lock(&async_mutex);
+	async_quit = true;
+	pthread_cond_broadcast(&async_work_cond);
+	pthread_mutex_unlock(&async_mutex);
 
-	char* state;
-	char* k = strtok_r(irc_tag_buf, ";", &state);
+	for(int i = 0; i < async_num_threads; ++i){
+		pthread_join(async_threads[i], NULL);
+	}
 
-	for(; k; k = strtok_r(NULL, ";", &state)){
-		char* v = k;
+	IRCAsyncJob* job;
+	while((job = util_async_pop(&async_pending))) free(job);
+	while((job = util_async_pop(&async_done)))    free(job);
 
-		while(*v && *v != '=') ++v;
+	util_fd_watch(async_eventfd, 0, NULL, NULL, NULL);
+	close(async_eventfd);
+}
 
-		if(*v == '='){
-			*v++ = '\0';
+static size_t util_event_str(IRCEventQueue* q, const char* str){
+	const size_t off = sb_count(q->strings) + 1;
+	const size_t len = strlen(str ? str : "");
 
-			for(char* p = v; *p; ++p){
-				if(*p != '\\') continue;
+	// leading NUL for the null-prefixed msg
+	char* p = sb_add(q->strings, len + 2);
+	*p = 0;
+	memcpy(p + 1, str ? str : "", len + 1);
 
-				if(p[1] == ':') *p = ';';
-				else if(p[1] == 's') *p = ' ';
-				else if(p[1] == 'r') *p = '\r';
-				else if(p[1] == 'n') *p = '\n';
+	return off;
+}
 
-				for(char* q = p + 1; *q; ++q){
-					q[0] = q[1];
-				}
-			}
-		}
+static void util_event_push(int type, const char* chan, const char* origin, const char* msg){
+	IRCEventQueue* q = event_queues + event_queue_cur;
+	IRCEvent ev = { .type = type };
 
-		sb_push(irc_tag_ptrs, k);
-		sb_push(irc_tag_ptrs, v);
+	// events for the same channel share its string, which lets util_perm_cache_get notice the batch
+	const IRCEvent* prev = sb_count(q->events) ? &sb_last(q->events) : NULL;
+	if(chan && prev && prev->chan && strcmp(q->strings + prev->chan, chan) == 0){
+		ev.chan = prev->chan;
+	} else if(chan){
+		ev.chan = util_event_str(q, chan);
 	}
-}
 
-/*****************
- * IRC Callbacks *
- *****************/
+	ev.origin = util_event_str(q, origin);
+	ev.msg    = util_event_str(q, msg);
 
-IRC_STR_CALLBACK(on_connect) {
-	printf("Our nick is %s\n", params[0]);
-	free(bot_nick);
-	bot_nick = strdup(params[0]);
+	sb_push(q->events, ev);
+}
 
-	IRC_MOD_CALL_ALL(on_connect, (serv));
+static bool util_events_pending(void){
+	return sb_count(event_queues[event_queue_cur].events) > 0;
 }
 
-IRC_STR_CALLBACK(on_chat_msg) {
-	if(count < 2 || !params[0] || !params[1]) return;
+// handles the events queued by gen_event so far. Ones that they generate are handled on the next call.
+static void util_process_events(void){
+	IRCEventQueue* q = event_queues + event_queue_cur;
+	if(!sb_count(q->events)) return;
 
-	util_update_tags(params);
+	event_queue_cur ^= 1;
 
-	const char *_chan = params[0], *_name = origin;
+	// synthetic events have no tags
+	irc_tag_raw     = NULL;
+	irc_tags_parsed = false;
 
-	size_t msglen = strlen(params[1]);
-	char*  msgbuf = alloca(msglen+2);
-	char*  _msg   = msgbuf + 1;
+	for(IRCEvent* ev = q->events; ev < sb_end(q->events); ++ev){
+		const char* chan   = ev->chan ? q->strings + ev->chan : NULL;
+		const char* origin = q->strings + ev->origin;
+		const char* msg    = q->strings + ev->msg;
 
-	// null-prefix the msg, so that cmds can walk backwards to see the full msg
-	*msgbuf = 0;
-	memcpy(_msg, params[1], msglen+1);
+		if(chan != perm_batch_chan){
+			perm_batch_chan  = chan;
+			perm_batch_index = -1;
+		}
 
-	util_trim_end_spaces(_msg, msglen);
+		switch(ev->type){
+			case IRC_CB_MSG: {
+				irc_on_chat_msg("", origin, (const char*[]){ chan, msg }, 2);
+			} break;
 
-	send_msg_called = false;
+			case IRC_CB_ACTION: {
+				irc_on_action("", origin, (const char*[]){ chan, msg }, 2);
+			} break;
 
-	for(Module* m = irc_modules; m < sb_end(irc_modules); ++m){
-		bool global = m->ctx->flags & IRC_MOD_GLOBAL;
-		if(global || util_check_perms(m->ctx->name, _chan, IRC_CB_CMD)){
-			util_dispatch_cmds(m, _chan, _name, _msg);
-		}
-		if(global || util_check_perms(m->ctx->name, _chan, IRC_CB_MSG)){
-			IRC_MOD_CALL(m, on_msg, (_chan, _name, _msg));
+			case IRC_CB_JOIN: {
+				irc_on_join("", origin, &chan, 1);
+			} break;
+
+			case IRC_CB_PART: {
+				irc_on_part("", origin, &chan, 1);
+			} break;
+
+			case IRC_CB_NICK: {
+				irc_on_nick("", origin, &msg, 1);
+			} break;
+
+			case IRC_CB_PM: {
+				irc_on_pm("", origin, (const char*[]){ "", msg }, 2);
+			} break;
 		}
 	}
-}
 
-IRC_STR_CALLBACK(on_action) {
-	if(count < 2 || !params[0] || !params[1]) return;
+	perm_batch_chan  = NULL;
+	perm_batch_index = -1;
+	irc_tag_raw      = NULL;
 
-	util_update_tags(params);
+	stb__sbn(q->events)  = 0;
+	stb__sbn(q->strings) = 0;
+}
 
-	const char *_chan = params[0], *_name = origin;
-	char* _msg = strdupa(params[1]);
-	util_trim_end_spaces(_msg, strlen(_msg));
+static bool util_timer_before(const IRCTimer* a, const IRCTimer* b){
+	return a->due_ms < b->due_ms || (a->due_ms == b->due_ms && a->id < b->id);
+}
 
-	IRC_MOD_CALL_ALL_CHECK(on_action, (_chan, _name, _msg), IRC_CB_ACTION);
+static void util_timer_swap(size_t a, size_t b){
+	IRCTimer tmp = timers[a];
+	timers[a] = timers[b];
+	timers[b] = tmp;
 }
 
-IRC_STR_CALLBACK(on_pm){
-	if(count < 2 || !params[1] || !origin) return;
+static void util_timer_sift_up(size_t i){
+	while(i > 0){
+		size_t parent = (i - 1) / 2;
+		if(!util_timer_before(timers + i, timers + parent)) break;
+		util_timer_swap(i, parent);
+		i = parent;
+	}
+}
 
-	util_update_tags(params);
+static void util_timer_sift_down(size_t i){
+	const size_t n = sb_count(timers);
 
-	const char* _name = origin;
-	char* _msg = strdupa(params[1]);
-	util_trim_end_spaces(_msg, strlen(_msg));
+	for(;;){
+		size_t l = i * 2 + 1, r = l + 1, min = i;
 
-	IRC_MOD_CALL_ALL(on_pm, (_name, _msg));
+		if(l < n && util_timer_before(timers + l, timers + min)) min = l;
+		if(r < n && util_timer_before(timers + r, timers + min)) min = r;
+		if(min == i) break;
+
+		util_timer_swap(i, min);
+		i = min;
+	}
 }
 
-IRC_STR_CALLBACK(on_join) {
-	if(count < 1 || !origin || !params[0]) return;
-	fprintf(stderr, "JOIN: %s %s\n", params[0], origin);
+static void util_timer_remove(size_t i){
+	const size_t last = sb_count(timers) - 1;
 
-	int chan_i, nick_i;
-	util_find_chan_nick(params[0], origin, &chan_i, &nick_i);
+	if(i != last){
+		timers[i] = timers[last];
+		stb__sbn(timers)--;
 
-	if(chan_i == -1){
-		sb_last(channels) = strdup(params[0]);
-		chan_i = sb_count(channels) - 1;
-		
-		sb_push(channels, 0);
-		sb_push(chan_nicks, 0);
+		util_timer_sift_down(i);
+		util_timer_sift_up(i);
+	} else {
+		stb__sbn(timers)--;
 	}
+}
 
-	if(nick_i == -1){
-		sb_push(chan_nicks[chan_i], strdup(origin));
-	}
+static int util_timer_add(int64_t delay_ms, int64_t repeat_ms, IRCModuleCtx* owner, IRCTimerCallback cb, void* arg){
+	if(++last_timer_id <= 0) last_timer_id = 1;
 
-	// if we're joining the debug channel, set the global so we know we can now send stuff
-	const char* c = getenv("INSOBOT_DEBUG_CHAN");
-	if(c && strcmp(origin, bot_nick) == 0 && strcmp(params[0], c) == 0){
-		debug_chan = c;
+	sb_push(timers, ((IRCTimer){
+		.id        = last_timer_id,
+		.due_ms    = util_mono_ms() + INSO_MAX(0, delay_ms),
+		.repeat_ms = INSO_MAX(0, repeat_ms),
+		.owner     = owner,
+		.cb        = cb,
+		.arg       = arg,
+	}));
+	util_timer_sift_up(sb_count(timers) - 1);
+
+	return last_timer_id;
+}
+
+static void util_timer_cancel(int id){
+	for(size_t i = 0; i < sb_count(timers); ++i){
+		if(timers[i].id == id){
+			util_timer_remove(i);
+			return;
+		}
 	}
+}
 
-	//XXX: can't use CHECK here unless our own name bypasses it FIXME
-	IRC_MOD_CALL_ALL(on_join, (params[0], origin));
+static void util_timer_cancel_all(const IRCModuleCtx* owner){
+	for(size_t i = sb_count(timers); i-- > 0 ;){
+		if(timers[i].owner == owner){
+			util_timer_remove(i);
+			i = sb_count(timers);
+		}
+	}
 }
 
-IRC_STR_CALLBACK(on_part) {
-	if(count < 1 || !origin || !params[0]) return;
+// ms until the next timer is due, or -1 if there are none
+static int64_t util_timer_next_wait(void){
+	if(!sb_count(timers)) return -1;
+	return INSO_MAX(0, timers[0].due_ms - util_mono_ms());
+}
 
-	int chan_i, nick_i;
-	util_find_chan_nick(params[0], origin, &chan_i, &nick_i);
+static void util_timers_run(void){
+	const int64_t now = util_mono_ms();
 
-	printf("PART: %s %s\n", params[0], origin);
+	// don't run more than there were to begin with, so a timer re-adding itself with 0 delay can't hog the loop
+	for(size_t budget = sb_count(timers); budget && sb_count(timers) && timers[0].due_ms <= now; --budget){
+		IRCTimer t = timers[0];
 
-	if(chan_i != -1 && strcasecmp(origin, bot_nick) == 0){
-		free(channels[chan_i]);
-		sb_erase(channels, chan_i);
+		if(t.repeat_ms){
+			timers[0].due_ms += t.repeat_ms;
+			if(timers[0].due_ms <= now){
+				timers[0].due_ms = now + t.repeat_ms;
+			}
+			util_timer_sift_down(0);
+		} else {
+			util_timer_remove(0);
+		}
 
-		for(size_t i = 0; i < sb_count(chan_nicks[chan_i]); ++i){
-			free(chan_nicks[chan_i][i]);
+		Module* m = NULL;
+		if(t.owner && !(m = util_module_from_ctx(t.owner))){
+			continue;
 		}
-		sb_free(chan_nicks[chan_i]);
-		sb_erase(chan_nicks, chan_i);
 
-	} else if(nick_i != -1){
-		free(chan_nicks[chan_i][nick_i]);
-		sb_erase(chan_nicks[chan_i], nick_i);
+		if(m) sb_push(mod_call_stack, m);
+		const int64_t start = util_stats_now();
+		t.cb(t.id, t.arg);
+		util_stats_record(m, MOD_STAT_TIMER, start);
+		if(m) sb_pop(mod_call_stack);
 	}
+}
 
-	IRC_MOD_CALL_ALL_CHECK(on_part, (params[0], origin), IRC_CB_PART);
+// frees anything the core is keeping track of on behalf of a module that is being unloaded
+static void util_release_owned(const IRCModuleCtx* owner){
+	util_fd_unwatch_all(owner);
+	util_timer_cancel_all(owner);
+	util_http_cancel_all(owner);
+	util_async_cancel_all(owner);
 }
 
-IRC_STR_CALLBACK(on_quit) {
-	if(!origin) return;
+static uint32_t util_hash_nocase(const char* word, size_t len){
+	uint32_t hash = 2166136261u;
+	for(size_t i = 0; i < len; ++i){
+		hash ^= (uint8_t)tolower((uint8_t)word[i]);
+		hash *= 16777619u;
+	}
+	return hash;
+}
 
-	util_update_tags(params);
+static uint32_t util_ipc_mod_id(const char* name){
+	uint32_t id = util_hash_nocase(name, strlen(name));
+	return id ? id : 1;
+}
 
-	printf("QUIT: %s\n", origin);
+static CmdIndexEntry* util_cmd_index_slot(const char* word, size_t len, uint32_t hash){
+	for(size_t i = hash & (cmd_index_size - 1);; i = (i + 1) & (cmd_index_size - 1)){
+		CmdIndexEntry* e = cmd_index + i;
+		if(!e->word || (e->hash == hash && strncasecmp(e->word, word, len) == 0 && e->word[len] == '\0')){
+			return e;
+		}
+	}
+}
 
-	for(size_t i = 0; i < sb_count(channels) - 1; ++i){
-		for(size_t j = 0; j < sb_count(chan_nicks[i]); ++j){
-			if(strcmp(origin, chan_nicks[i][j]) == 0){
-				free(chan_nicks[i][j]);
-				sb_erase(chan_nicks[i], j);
+static const CmdIndexEntry* util_cmd_index_find(const char* word, size_t len){
+	if(!cmd_index) return NULL;
 
-				IRC_MOD_CALL_ALL_CHECK(on_part, (channels[i], origin), IRC_CB_PART);
-				break;
+	const CmdIndexEntry* e = util_cmd_index_slot(word, len, util_hash_nocase(word, len));
+	return e->word ? e : NULL;
+}
+
+static void util_cmd_index_free(void){
+	for(size_t i = 0; i < cmd_index_size; ++i){
+		free(cmd_index[i].word);
+		sb_free(cmd_index[i].handlers);
+	}
+	free(cmd_index);
+	cmd_index = NULL;
+	cmd_index_size = 0;
+}
+
+// maps each space-separated alias in the modules' command lists to the (module, command) pairs using it.
+// irc_modules must already be sorted, since the handlers are stored by index.
+static void util_cmd_index_build(void){
+	size_t num_aliases = 0;
+
+	util_cmd_index_free();
+
+	for(Module* m = irc_modules; m < sb_end(irc_modules); ++m){
+		if(!m->ctx->commands || !m->ctx->on_cmd || m->init_state != MOD_INIT_READY) continue;
+
+		for(const char** cmd_list = m->ctx->commands; *cmd_list; ++cmd_list){
+			for(const char* c = *cmd_list; *c; ++c){
+				if(*c != ' ' && (c[1] == ' ' || c[1] == '\0')) ++num_aliases;
+			}
+		}
+	}
+
+	cmd_index_size = 16;
+	while(cmd_index_size < num_aliases * 2) cmd_index_size *= 2;
+	cmd_index = calloc(cmd_index_size, sizeof(*cmd_index));
+
+	for(Module* m = irc_modules; m < sb_end(irc_modules); ++m){
+		if(!m->ctx->commands || !m->ctx->on_cmd || m->init_state != MOD_INIT_READY) continue;
+
+		for(const char** cmd_list = m->ctx->commands; *cmd_list; ++cmd_list){
+			const char* cmd = *cmd_list;
+
+			while(*cmd){
+				while(*cmd == ' ') ++cmd;
+				const size_t sz = strchrnul(cmd, ' ') - cmd;
+				if(!sz) break;
+
+				const uint32_t hash = util_hash_nocase(cmd, sz);
+				CmdIndexEntry* e = util_cmd_index_slot(cmd, sz, hash);
+
+				if(!e->word){
+					e->word = strndup(cmd, sz);
+					e->hash = hash;
+					for(char* p = e->word; *p; ++p) *p = tolower((uint8_t)*p);
+				}
+
+				CmdHandler h = { .mod = m - irc_modules, .cmd = cmd_list - m->ctx->commands };
+
+				// the same alias twice in one entry still only calls on_cmd once
+				if(sb_count(e->handlers) == 0 || memcmp(&sb_last(e->handlers), &h, sizeof(h)) != 0){
+					sb_push(e->handlers, h);
+				}
+
+				cmd += sz;
 			}
 		}
 	}
 }
 
-IRC_STR_CALLBACK(on_nick) {
-	if(count < 1 || !origin || !params[0]) return;
+static void util_dispatch_cmds(Module* m, const CmdHandler* begin, const CmdHandler* end, const char* chan, const char* name, const char* arg){
+	for(const CmdHandler* h = begin; h < end; ++h){
+		IRC_MOD_CALL(m, on_cmd, (chan, name, arg, h->cmd));
+	}
+}
 
-	util_update_tags(params);
+static IRCName* util_names_find(const NameTable* t, const char* name){
+	if(!t->size) return NULL;
 
-	if(strcmp(origin, bot_nick) == 0){
-		printf("We changed nicks! new nick: %s\n", params[0]);
-		free(bot_nick);
-		bot_nick = strdup(params[0]);
+	const uint32_t hash = util_irc_hash(name);
+	for(IRCName* n = t->buckets[hash & (t->size - 1)]; n; n = n->next){
+		if(n->hash == hash && util_irc_streq(n->name, name)) return n;
 	}
 
-	for(size_t i = 0; i < sb_count(channels) - 1; ++i){
-		for(size_t j = 0; j < sb_count(chan_nicks[i]); ++j){
-			if(strcasecmp(chan_nicks[i][j], origin) == 0){
-				free(chan_nicks[i][j]);
-				chan_nicks[i][j] = strdup(params[0]);
-				break;
+	return NULL;
+}
+
+static void util_names_insert(NameTable* t, IRCName* entry){
+	if(t->count >= t->size){
+		size_t new_size = t->size ? t->size * 2 : 64;
+		IRCName** new_buckets = calloc(new_size, sizeof(*new_buckets));
+
+		for(size_t i = 0; i < t->size; ++i){
+			IRCName* n = t->buckets[i];
+			while(n){
+				IRCName* next = n->next;
+				n->next = new_buckets[n->hash & (new_size - 1)];
+				new_buckets[n->hash & (new_size - 1)] = n;
+				n = next;
 			}
 		}
+
+		free(t->buckets);
+		t->buckets = new_buckets;
+		t->size = new_size;
 	}
 
-	IRC_MOD_CALL_ALL(on_nick, (origin, params[0]));
+	entry->hash = util_irc_hash(entry->name);
+	IRCName** bucket = t->buckets + (entry->hash & (t->size - 1));
+	entry->next = *bucket;
+	*bucket = entry;
+	++t->count;
 }
 
-IRC_STR_CALLBACK(on_unknown) {
-	if(strcmp(event, "PONG") == 0){
-//		printf(":: PONG");
+static void util_names_remove(NameTable* t, IRCName* entry){
+	for(IRCName** n = t->buckets + (entry->hash & (t->size - 1)); *n; n = &(*n)->next){
+		if(*n == entry){
+			*n = entry->next;
+			--t->count;
+			return;
+		}
+	}
+}
+
+static IRCChan* util_chan_find(const char* chan){
+	return (IRCChan*)util_names_find(&chan_table, chan);
+}
+
+static IRCNick* util_nick_find(const char* nick){
+	return (IRCNick*)util_names_find(&nick_table, nick);
+}
+
+static IRCChan* util_chan_add(const char* name){
+	IRCChan* chan = util_chan_find(name);
+	if(chan) return chan;
+
+	chan = calloc(1, sizeof(*chan));
+	chan->key.name = strdup(name);
+	util_names_insert(&chan_table, &chan->key);
+
+	sb_last(channels) = chan->key.name;
+	sb_push(channels, 0);
+
+	return chan;
+}
+
+static IRCMembership* util_member_find(IRCNick* nick, const IRCChan* chan){
+	for(IRCMembership* mem = nick->chans; mem < sb_end(nick->chans); ++mem){
+		if(mem->chan == chan) return mem;
+	}
+	return NULL;
+}
+
+// nicks are only in a handful of channels at most, so their membership lists are just scanned
+static void util_member_add(IRCChan* chan, const char* name){
+	IRCNick* nick = util_nick_find(name);
+
+	if(!nick){
+		nick = calloc(1, sizeof(*nick));
+		nick->key.name = strdup(name);
+		util_names_insert(&nick_table, &nick->key);
+	} else if(util_member_find(nick, chan)){
+		return;
+	}
+
+	IRCMembership mem = { .chan = chan, .index = sb_count(chan->nicks) };
+	sb_push(nick->chans, mem);
+
+	sb_push(chan->nicks, nick->key.name);
+	sb_push(chan->members, nick);
+}
+
+static void util_member_remove(IRCChan* chan, IRCNick* nick){
+	IRCMembership* mem = util_member_find(nick, chan);
+	if(!mem) return;
+
+	// move the last nick of the channel into the removed one's place
+	const size_t index = mem->index;
+	const size_t last  = sb_count(chan->nicks) - 1;
+
+	if(index != last){
+		IRCNick* moved = chan->members[last];
+		chan->nicks[index]   = chan->nicks[last];
+		chan->members[index] = moved;
+		util_member_find(moved, chan)->index = index;
+	}
+	sb_pop(chan->nicks);
+	sb_pop(chan->members);
+
+	sb_erase(nick->chans, mem - nick->chans);
+
+	if(sb_count(nick->chans) == 0){
+		util_names_remove(&nick_table, &nick->key);
+		free(nick->key.name);
+		sb_free(nick->chans);
+		free(nick);
+	}
+}
+
+static void util_chan_remove(IRCChan* chan){
+	while(sb_count(chan->members) > 0){
+		util_member_remove(chan, sb_last(chan->members));
+	}
+
+	for(char** c = channels; *c; ++c){
+		if(*c == chan->key.name){
+			sb_erase(channels, c - channels);
+			break;
+		}
+	}
+
+	util_names_remove(&chan_table, &chan->key);
+	free(chan->key.name);
+	sb_free(chan->nicks);
+	sb_free(chan->members);
+	free(chan);
+}
+
+static void util_nick_rename(IRCNick* nick, const char* new_name){
+	IRCNick* existing = util_nick_find(new_name);
+
+	// shouldn't happen, but if the new nick is already known then merge into it
+	if(existing && existing != nick){
+		// the last removal frees nick
+		for(size_t i = sb_count(nick->chans); i > 0; --i){
+			IRCChan* chan = sb_last(nick->chans).chan;
+			util_member_remove(chan, nick);
+			util_member_add(chan, new_name);
+		}
 		return;
+	}
+
+	util_names_remove(&nick_table, &nick->key);
+	free(nick->key.name);
+	nick->key.name = strdup(new_name);
+	util_names_insert(&nick_table, &nick->key);
+
+	for(IRCMembership* mem = nick->chans; mem < sb_end(nick->chans); ++mem){
+		mem->chan->nicks[mem->index] = nick->key.name;
+	}
+}
+
+// gives m the nicks in chan with on_names, or on_join for each if it doesn't have it
+static void util_mod_names(Module* m, const char* chan, const char** nicks, size_t count){
+	if(MOD_HAS_CB(m, on_names)){
+		IRC_MOD_CALL(m, on_names, (chan, nicks, count));
+	} else if(m->ctx->on_join){
+		for(size_t i = 0; i < count; ++i){
+			IRC_MOD_CALL(m, on_join, (chan, nicks[i]));
+		}
+	}
+}
+
+static void util_rate_init(void){
+	bool twitch = strcasestr(serv, "twitch.tv") || getenv("IRC_IS_TWITCH");
+
+	if(twitch){
+		rate_limits = rate_profiles + (getenv("IRC_TWITCH_MOD") ? 2 : 1);
 	} else {
-		printf("Unknown event:\n:: %s :: %s", event, origin);
+		rate_limits = rate_profiles;
 	}
 
-	for(size_t i = 0; i < count; ++i){
-		printf(" :: %s", params[i]);
+	printf("Using %s rate limits.\n", rate_limits->name);
+}
+
+static void util_bucket_refill(RateBucket* b, int burst, int period_ms, int64_t now){
+	if(b->last_ms == 0){
+		b->tokens = burst;
+	} else {
+		b->tokens = INSO_MIN((double)burst, b->tokens + (now - b->last_ms) * burst / (double)period_ms);
 	}
-	puts("");
+	b->last_ms = now;
+}
 
-	IRC_MOD_CALL_ALL_ABI(on_unknown, (event, origin, params, count), ABI_UNKNOWN);
+// ms until the bucket has a token available
+static int64_t util_bucket_wait(RateBucket* b, int burst, int period_ms, int64_t now){
+	util_bucket_refill(b, burst, period_ms, now);
+	if(b->tokens >= 1.0) return 0;
+	return (int64_t)((1.0 - b->tokens) * period_ms / burst) + 1;
 }
 
-IRC_NUM_CALLBACK(on_numeric) {
-	static const char nick_start_symbols[] = "[]\\`_^{|}";
-	
-	if(event == LIBIRC_RFC_RPL_NAMREPLY && count >= 4 && params[3]){
-		char *names = strdup(params[3]), 
-		     *state = NULL,
-		     *n     = strtok_r(names, " ", &state);
+static void util_target_bucket_free(TargetBucket* t){
+	util_names_remove(&rate_target_table, &t->key);
+	free(t->key.name);
+	free(t);
+}
 
-		do {
-			if(!isalpha(*n) && !strchr(nick_start_symbols, *n)){
-				++n;
+// drops the per-target buckets that have refilled, since a new one starts out full anyway.
+// the rest have had something sent to them recently, so the table only holds the active targets.
+static void util_rate_sweep_cb(int id, void* arg){
+	const RateLimits* r = rate_limits;
+	const int64_t now = util_mono_ms();
+
+	for(size_t i = 0; i < rate_target_table.size; ++i){
+		IRCName* n = rate_target_table.buckets[i];
+		while(n){
+			IRCName* next = n->next;
+			TargetBucket* t = (TargetBucket*)n;
+
+			util_bucket_refill(&t->bucket, r->chan_burst, r->chan_period, now);
+			if(t->bucket.tokens >= r->chan_burst){
+				util_target_bucket_free(t);
 			}
-			irc_on_join(session, "join", n, (const char**)(params + 2), 1);
-		} while((n = strtok_r(NULL, " ", &state)));
-		
-		free(names);
+
+			n = next;
+		}
+	}
+
+	if(rate_target_table.count == 0){
+		util_timer_cancel(id);
+		rate_sweep_timer = 0;
+	}
+}
+
+static RateBucket* util_target_bucket(const char* target){
+	TargetBucket* t = (TargetBucket*)util_names_find(&rate_target_table, target);
+	if(t) return &t->bucket;
+
+	t = calloc(1, sizeof(*t));
+	t->key.name = strdup(target);
+	util_names_insert(&rate_target_table, &t->key);
+
+	if(!rate_sweep_timer){
+		rate_sweep_timer = util_timer_add(RATE_SWEEP_MS, RATE_SWEEP_MS, NULL, &util_rate_sweep_cb, NULL);
+	}
+
+	return &t->bucket;
+}
+
+// fills buckets with the (up to 2) buckets that must have a token for cmd to be sent, returns how many
+static int util_cmd_buckets(const IRCCmd* cmd, RateBucket** buckets, int* bursts, int* periods){
+	const RateLimits* r = rate_limits;
+	int n = 0;
+
+	if((cmd->cmd == IRC_CMD_JOIN || cmd->cmd == IRC_CMD_PART) && r->join_burst){
+		buckets[n] = &rate_join_bucket;
+		bursts [n] = r->join_burst;
+		periods[n] = r->join_period;
+		++n;
 	} else {
-		printf(":: [%03u] :: %s", event, origin);
-		for(size_t i = 0; i < count; ++i){
-			printf(" :: %s", params[i]);
+		buckets[n] = &rate_msg_bucket;
+		bursts [n] = r->msg_burst;
+		periods[n] = r->msg_period;
+		++n;
+	}
+
+	if(cmd->cmd == IRC_CMD_MSG && r->chan_burst){
+		buckets[n] = util_target_bucket(cmd->chan);
+		bursts [n] = r->chan_burst;
+		periods[n] = r->chan_period;
+		++n;
+	}
+
+	return n;
+}
+
+static int64_t util_cmd_wait(const IRCCmd* cmd, int64_t now){
+	RateBucket* buckets[2];
+	int bursts[2], periods[2];
+	int64_t wait = 0;
+
+	int n = util_cmd_buckets(cmd, buckets, bursts, periods);
+	for(int i = 0; i < n; ++i){
+		wait = INSO_MAX(wait, util_bucket_wait(buckets[i], bursts[i], periods[i], now));
+	}
+
+	return wait;
+}
+
+static void util_cmd_take(const IRCCmd* cmd){
+	RateBucket* buckets[2];
+	int bursts[2], periods[2];
+
+	int n = util_cmd_buckets(cmd, buckets, bursts, periods);
+	for(int i = 0; i < n; ++i){
+		buckets[i]->tokens -= 1.0;
+	}
+}
+
+static bool util_cmd_is_moderation(int cmd, const char* data){
+	static const char* twitch_mod_cmds[] = {
+		"timeout", "untimeout", "ban", "unban", "clear", "delete", "slow", "slowoff",
+		"followers", "followersoff", "subscribers", "subscribersoff", "emoteonly", "emoteonlyoff",
+	};
+
+	if(cmd == IRC_CMD_RAW){
+		return strncasecmp(data, "KICK ", 5) == 0 || strncasecmp(data, "MODE ", 5) == 0;
+	}
+
+	if(cmd == IRC_CMD_MSG && (*data == '.' || *data == '/')){
+		size_t len = strcspn(data + 1, " ");
+		for(size_t i = 0; i < ARRAY_SIZE(twitch_mod_cmds); ++i){
+			if(strlen(twitch_mod_cmds[i]) == len && strncasecmp(data + 1, twitch_mod_cmds[i], len) == 0){
+				return true;
+			}
+		}
+	}
+
+	return false;
+}
+
+static int util_cmd_lane(int cmd, const char* data){
+	if(cmd == IRC_CMD_JOIN || cmd == IRC_CMD_PART || util_cmd_is_moderation(cmd, data)){
+		return CMD_LANE_HIGH;
+	}
+	return handling_msg ? CMD_LANE_NORMAL : CMD_LANE_LOW;
+}
+
+#define CMD_SLOT(lane, n) (cmd_queue[lane].slots + ((n) % CMD_RING_SIZE))
+
+static uint32_t util_cmd_total(void){
+	uint32_t total = 0;
+	for(int lane = 0; lane < CMD_LANE_COUNT; ++lane){
+		total += cmd_queue[lane].count;
+	}
+	return total;
+}
+
+// advances the head past slots that were already sent / dropped
+static void util_cmd_reclaim(int lane){
+	IRCCmdRing* r = cmd_queue + lane;
+	while(r->head != r->tail && CMD_SLOT(lane, r->head)->state == CMD_FREE){
+		++r->head;
+	}
+}
+
+static void util_cmd_release(int lane, IRCCmd* cmd){
+	cmd->state = CMD_FREE;
+	--cmd_queue[lane].count;
+	util_cmd_reclaim(lane);
+}
+
+static void util_cmd_drop(int lane, IRCCmd* cmd, const char* why){
+	util_log(IRC_LOG_WARN, "Dropping queued command (%s): [%s] [%s]\n", why, cmd->chan, cmd->data);
+	++cmd_queue[lane].dropped;
+	util_cmd_release(lane, cmd);
+}
+
+static IRCCmd* util_cmd_oldest(int lane){
+	IRCCmdRing* r = cmd_queue + lane;
+	for(uint32_t n = r->head; n != r->tail; ++n){
+		if(CMD_SLOT(lane, n)->state == CMD_QUEUED) return CMD_SLOT(lane, n);
+	}
+	return NULL;
+}
+
+// Drop policy: when a lane is full, the oldest command in it is dropped to make room,
+// except for the HIGH lane where the new command is refused instead.
+static size_t util_cmd_push(int cmd, const char* chan, const char* data, size_t data_len, size_t id){
+	int lane = util_cmd_lane(cmd, data);
+	IRCCmdRing* r = cmd_queue + lane;
+
+	if((chan && strlen(chan) >= CMD_CHAN_MAX) || data_len >= IRC_LINE_MAX){
+		printf("Command too long, refusing: [%s] [%.*s]\n", chan ? chan : "", (int)data_len, data ? data : "");
+		return 0;
+	}
+
+	util_cmd_reclaim(lane);
+
+	if(r->count >= CMD_QUEUE_MAX || r->tail - r->head >= CMD_RING_SIZE){
+		IRCCmd* oldest = util_cmd_oldest(lane);
+
+		bool ring_full = r->tail - r->head >= CMD_RING_SIZE;
+
+		// dropping only makes room in a physically full ring if the oldest command is at the head
+		if(lane == CMD_LANE_HIGH || !oldest || (ring_full && oldest != CMD_SLOT(lane, r->head))){
+			printf("Command queue full, refusing: [%s] [%.*s]\n", chan ? chan : "", (int)data_len, data ? data : "");
+			++r->dropped;
+			return 0;
 		}
-		puts("");
+
+		util_cmd_drop(lane, oldest, "queue full");
+	}
+
+	if(!id){
+		id = ++last_cmd_id;
+		if(!id) ++id;
 	}
+
+	IRCCmd* c = CMD_SLOT(lane, r->tail++);
+
+	c->id        = id;
+	c->cmd       = cmd;
+	c->state     = CMD_QUEUED;
+	c->filtered  = false;
+	c->queued_ms = util_mono_ms();
+
+	memcpy(c->chan, chan ? chan : "", chan ? strlen(chan) + 1 : 1);
+	memcpy(c->data, data ? data : "", data_len);
+	c->data[data_len] = 0;
+
+	r->high_water        = INSO_MAX(r->high_water, ++r->count);
+	cmd_queue_high_water = INSO_MAX(cmd_queue_high_water, util_cmd_total());
+
+	return id;
+}
+
+static size_t util_cmd_enqueue(int cmd, const char* chan, const char* data){
+	return util_cmd_push(cmd, chan, data, data ? strlen(data) : 0, 0);
 }
 
-/********************
- * IRCCoreCtx funcs *
- ********************/
+// the server prepends ":nick!user@host " to our PRIVMSGs when relaying them, and the whole
+// line has to fit in IRC_LINE_MAX, so leave room for that with a generous guess for the host.
+static size_t util_msg_max_len(const char* chan){
+	const size_t prefix   = 1 + strlen(bot_nick) + 1 + strlen(user) + 1 + 64 + 1;
+	const size_t overhead = prefix + strlen("PRIVMSG ") + strlen(chan) + strlen(" :") + strlen("\r\n");
+
+	return IRC_LINE_MAX > overhead + 64 ? IRC_LINE_MAX - overhead : 64;
+}
+
+// how many bytes of msg go into a line of at most max bytes: never in the middle of a utf-8
+// sequence, and at a space if there's one near enough to the end.
+static size_t util_msg_split_len(const char* msg, size_t len, size_t max){
+	if(len <= max) return len;
+
+	size_t n = max;
+	while(n > 0 && (msg[n] & 0xC0) == 0x80) --n;
+
+	for(size_t i = n; i > max - (max / 4); --i){
+		if(msg[i] == ' ') return i;
+	}
+
+	return n ? n : max;
+}
+
+// long messages are split into several lines, which all have the same id.
+static size_t util_msg_enqueue(const char* chan, const char* msg, size_t len){
+	const size_t max = util_msg_max_len(chan);
+	size_t id = 0;
+
+	while(len > 0){
+		size_t n = util_msg_split_len(msg, len, max);
+		size_t trimmed = n;
+
+		while(n < len && trimmed > 1 && msg[trimmed-1] == ' '){
+			--trimmed;
+		}
+
+		size_t piece_id = util_cmd_push(IRC_CMD_MSG, chan, msg, trimmed, id);
+		if(!id) id = piece_id;
+
+		msg += n;
+		len -= n;
+
+		while(len > 0 && *msg == ' '){
+			++msg;
+			--len;
+		}
+	}
+
+	return id;
+}
+
+// commands to the same target are kept in order within a lane, so only the first one for each can be sent
+static bool util_cmd_is_eligible(int lane, uint32_t index){
+	const IRCCmd* cmd = CMD_SLOT(lane, index);
+
+	for(uint32_t n = cmd_queue[lane].head; n != index; ++n){
+		const IRCCmd* prev = CMD_SLOT(lane, n);
+		if(prev->state == CMD_FREE || prev->cmd != cmd->cmd) continue;
+		if(!*prev->chan || !*cmd->chan || strcasecmp(prev->chan, cmd->chan) == 0){
+			return false;
+		}
+	}
+
+	return true;
+}
+
+static bool util_irc_out_full(void){
+	return sb_count(irc_conn.out) - irc_conn.out_off > IRC_OUT_BUF_MAX;
+}
+
+// returns -1 if nothing is queued (or can be sent yet), otherwise the ms until something could be sent
+static int64_t util_cmd_next_wait(void){
+	int64_t now = util_mono_ms();
+	int64_t wait = -1;
+
+	// the irc fd's callback wakes the loop up once registration finishes or the output buffer drains
+	if(irc_conn.state != IRC_STATE_CONNECTED || util_irc_out_full()){
+		return -1;
+	}
+
+	for(int lane = 0; lane < CMD_LANE_COUNT; ++lane){
+		for(uint32_t n = cmd_queue[lane].head; n != cmd_queue[lane].tail; ++n){
+			if(CMD_SLOT(lane, n)->state != CMD_QUEUED || !util_cmd_is_eligible(lane, n)) continue;
+
+			int64_t w = util_cmd_wait(CMD_SLOT(lane, n), now);
+			if(wait == -1 || w < wait) wait = w;
+		}
+	}
+
+	return wait;
+}
+
+// Expire policy: chat messages that have been waiting longer than CMD_EXPIRE_MS are stale, drop them.
+static void util_cmd_expire(int64_t now){
+	for(int lane = CMD_LANE_NORMAL; lane < CMD_LANE_COUNT; ++lane){
+		for(uint32_t n = cmd_queue[lane].head; n != cmd_queue[lane].tail; ++n){
+			IRCCmd* cmd = CMD_SLOT(lane, n);
+			if(cmd->state == CMD_QUEUED && now - cmd->queued_ms > CMD_EXPIRE_MS){
+				util_cmd_drop(lane, cmd, "expired");
+			}
+		}
+	}
+}
+
+static void util_cmd_filter(IRCCmd* cmd){
+	if(cmd->filtered) return;
+	if(cmd->cmd != IRC_CMD_MSG && cmd->cmd != IRC_CMD_RAW) return;
+
+	size_t len = strlen(cmd->data);
+	const char* chan = cmd->cmd == IRC_CMD_MSG ? cmd->chan : NULL;
+	IRC_MOD_CALL_ALL(on_filter, (cmd->id, chan, cmd->data, len));
+
+	cmd->filtered = true;
+}
+
+// twitch commands and CTCP messages must be kept on their own line
+static bool util_msg_is_plain(const char* msg){
+	return *msg != '.' && *msg != '/' && *msg != '\001';
+}
+
+// Marks queued (plain) messages to the same channel that come after cmd in the lane, and that fit
+// into the same line, as being sent. Each one is filtered separately, with its own id, before being merged.
+static size_t util_cmd_coalesce(int lane, uint32_t index, const IRCCmd* cmd, IRCCmd** merged){
+	size_t num_merged = 0;
+
+	if(lane == CMD_LANE_HIGH || cmd->cmd != IRC_CMD_MSG || !util_msg_is_plain(cmd->data)){
+		return 0;
+	}
+
+	const size_t max = util_msg_max_len(cmd->chan);
+	size_t len = strlen(cmd->data);
+
+	for(uint32_t n = index + 1; n != cmd_queue[lane].tail && num_merged < CMD_QUEUE_MAX; ++n){
+		IRCCmd* next = CMD_SLOT(lane, n);
+
+		if(next->state != CMD_QUEUED || next->cmd != IRC_CMD_MSG || strcasecmp(next->chan, cmd->chan) != 0){
+			continue;
+		}
+
+		// messages to the same channel stay in order, so stop at the first one that can't be merged
+		if(!util_msg_is_plain(next->data)) break;
+
+		next->state = CMD_SENDING;
+		util_cmd_filter(next);
+
+		if(!*next->data){
+			util_cmd_release(lane, next);
+			continue;
+		}
+
+		size_t piece_len = strlen(CMD_COALESCE_SEP) + strlen(next->data);
+		if(len + piece_len > max){
+			next->state = CMD_QUEUED;
+			break;
+		}
+
+		len += piece_len;
+		merged[num_merged++] = next;
+	}
+
+	return num_merged;
+}
+
+// returns false if the connection's output buffer is full, in which case it should be kept queued.
+static bool util_cmd_send(const IRCCmd* cmd, IRCCmd** merged, size_t num_merged){
+	bool ret = true;
+
+	switch(cmd->cmd){
+
+		case IRC_CMD_JOIN: {
+			if(*cmd->data){
+				ret = util_irc_send("JOIN %s %s", cmd->chan, cmd->data);
+			} else {
+				ret = util_irc_send("JOIN %s", cmd->chan);
+			}
+		} break;
+
+		case IRC_CMD_PART: {
+			ret = util_irc_send("PART %s", cmd->chan);
+		} break;
+
+		case IRC_CMD_MSG: {
+			static char line_buf[IRC_LINE_MAX];
+			const char* line = cmd->data;
+
+			if(num_merged){
+				char*  p  = line_buf;
+				size_t sz = sizeof(line_buf);
+
+				snprintf_chain(&p, &sz, "%s", cmd->data);
+				for(size_t i = 0; i < num_merged; ++i){
+					snprintf_chain(&p, &sz, "%s%s", CMD_COALESCE_SEP, merged[i]->data);
+				}
+				line = line_buf;
+			}
+
+			util_log(IRC_LOG_INFO, "send: [%s] [%s]\n", cmd->chan, line);
+			ret = util_irc_send("PRIVMSG %s :%s", cmd->chan, line);
+		} break;
+
+		case IRC_CMD_RAW: {
+			ret = util_irc_send("%s", cmd->data);
+		} break;
+	}
+
+	return ret;
+}
+
+static void util_process_pending_cmds(void){
+	static IRCCmd* merged[CMD_QUEUE_MAX];
+
+	int64_t now = util_mono_ms();
+	util_cmd_expire(now);
+
+	// nothing queued can go out before registration is done, only util_irc_register's lines (and PONGs) are sent directly.
+	if(irc_conn.state != IRC_STATE_CONNECTED){
+		return;
+	}
+
+	// send as much as the buckets allow, restarting from the highest lane after each send
+	// so that a token that just became free always goes to the most important command.
+	bool sent;
+	do {
+		sent = false;
+
+		for(int lane = 0; lane < CMD_LANE_COUNT && !sent; ++lane){
+			for(uint32_t n = cmd_queue[lane].head; n != cmd_queue[lane].tail; ++n){
+				IRCCmd* cmd = CMD_SLOT(lane, n);
+
+				if(cmd->state != CMD_QUEUED || !util_cmd_is_eligible(lane, n) || util_cmd_wait(cmd, now) > 0){
+					continue;
+				}
+
+				sent = true;
+
+				cmd->state = CMD_SENDING;
+				util_cmd_filter(cmd);
+
+				// filtered out, doesn't use up a token
+				if(cmd->cmd != IRC_CMD_JOIN && cmd->cmd != IRC_CMD_PART && !*cmd->data){
+					util_cmd_release(lane, cmd);
+					break;
+				}
+
+				size_t num_merged = util_cmd_coalesce(lane, n, cmd, merged);
+
+				if(!util_cmd_send(cmd, merged, num_merged)){
+					// the connection's output buffer is full, try again once it has been flushed
+					cmd->state = CMD_QUEUED;
+					for(size_t i = 0; i < num_merged; ++i){
+						merged[i]->state = CMD_QUEUED;
+					}
+					return;
+				}
+
+				util_cmd_take(cmd);
+
+				if(cmd->cmd == IRC_CMD_MSG){
+					IRC_MOD_CALL_ALL(on_msg_out, (cmd->chan, cmd->data));
+					for(size_t i = 0; i < num_merged; ++i){
+						IRC_MOD_CALL_ALL(on_msg_out, (merged[i]->chan, merged[i]->data));
+					}
+				}
+
+				for(size_t i = 0; i < num_merged; ++i){
+					util_cmd_release(lane, merged[i]);
+				}
+				util_cmd_release(lane, cmd);
+
+				break;
+			}
+		}
+	} while(sent);
+}
+
+static void util_module_add(const char* name){
+	char path_buf[PATH_MAX];
+	const char* path = name;
+
+	if(!strchr(path, '/')){
+		if(strlen(inotify.module.path) + strlen(name) + 1 > sizeof(path_buf)) return;
+
+		strcpy(path_buf, inotify.module.path);
+		strcat(path_buf, name);
+		path = path_buf;
+	}
+
+	Module m = {
+		.lib_path     = strdup(path),
+		.log_level    = log_level_default,
+		.journal      = { .fd = -1 },
+		.needs_reload = true
+	};
+
+	sb_push(irc_modules, m);
+	mod_subs_dirty = true;
+}
+
+static uint32_t util_fnv1a(const void* data, size_t len){
+	const uint8_t* p = data;
+	uint32_t hash = 2166136261u;
+	for(size_t i = 0; i < len; ++i){
+		hash ^= p[i];
+		hash *= 16777619u;
+	}
+	return hash;
+}
+
+static int util_u32_cmp(const void* a, const void* b){
+	uint32_t x = *(const uint32_t*)a, y = *(const uint32_t*)b;
+	return (x > y) - (x < y);
+}
+
+// the journal functions below need the module to be on mod_call_stack, since they go through core_get_datafile.
+
+static const char* util_journal_path(uint32_t gen){
+	static char path[PATH_MAX];
+	snprintf(path, sizeof(path), "%s.journal.%u", core_get_datafile(), gen);
+	return path;
+}
+
+// sorted gens of the journal files on disk (sb)
+static uint32_t* util_journal_gens(void){
+	char pattern[PATH_MAX];
+	snprintf(pattern, sizeof(pattern), "%s.journal.*", core_get_datafile());
+
+	uint32_t* gens = NULL;
+	glob_t glob_data = {};
+
+	if(glob(pattern, GLOB_NOSORT, NULL, &glob_data) == 0){
+		for(size_t i = 0; i < glob_data.gl_pathc; ++i){
+			char* end;
+			unsigned long gen = strtoul(strrchr(glob_data.gl_pathv[i], '.') + 1, &end, 10);
+			if(*end == '\0' && gen > 0 && gen <= UINT32_MAX){
+				sb_push(gens, gen);
+			}
+		}
+	}
+	globfree(&glob_data);
+
+	if(gens){
+		qsort(gens, sb_count(gens), sizeof(*gens), &util_u32_cmp);
+	}
+
+	return gens;
+}
+
+static void util_journal_close(Module* m){
+	if(m->journal.fd != -1){
+		close(m->journal.fd);
+		m->journal.fd = -1;
+	}
+}
+
+static bool util_journal_open(Module* m){
+	uint32_t* gens = util_journal_gens();
+	uint32_t  gen  = INSO_MAX(m->journal.gen, gens ? sb_last(gens) : 0) + 1;
+	sb_free(gens);
+
+	// records go on top of the snapshot being written if there is one, otherwise the current data file.
+	uint64_t base_ino = 0;
+	uint64_t data_size = 0;
+
+	struct stat st;
+	if(stat(core_get_datafile(), &st) == 0){
+		base_ino  = st.st_ino;
+		data_size = st.st_size;
+	}
+
+	// journal compaction has the data in memory, a forked bg save doesn't so the old file size will have to do.
+	SaveSnapshot* snap = m->snapshot;
+	if(snap){
+		base_ino = snap->tmp_ino;
+		if(snap->data){
+			data_size = snap->data_len;
+		}
+	}
+
+	const char* path = util_journal_path(gen);
+	int fd = open(path, O_WRONLY | O_CREAT | O_EXCL | O_APPEND | O_CLOEXEC, 0600);
+	if(fd == -1){
+		fprintf(stderr, "Can't create journal for %s: %s\n", m->ctx->name, strerror(errno));
+		return false;
+	}
+
+	JournalHeader hdr = {
+		.magic    = JOURNAL_MAGIC,
+		.gen      = gen,
+		.base_ino = base_ino,
+	};
+
+	if(!util_write_all(fd, (char*)&hdr, sizeof(hdr))){
+		fprintf(stderr, "Can't write journal for %s: %s\n", m->ctx->name, strerror(errno));
+		close(fd);
+		unlink(path);
+		return false;
+	}
+
+	m->journal.fd         = fd;
+	m->journal.gen        = gen;
+	m->journal.size       = sizeof(hdr);
+	m->journal.compact_at = INSO_MAX((uint64_t)JOURNAL_COMPACT_MIN, data_size);
+
+	return true;
+}
+
+// closes the journal and deletes the files before gen
+static void util_journal_remove(Module* m, uint32_t gen){
+	if(m->journal.gen < gen){
+		util_journal_close(m);
+	}
+
+	uint32_t* gens = util_journal_gens();
+	for(uint32_t* g = gens; g < sb_end(gens); ++g){
+		if(*g < gen){
+			unlink(util_journal_path(*g));
+		}
+	}
+	sb_free(gens);
+}
+
+static void util_snapshot_free(SaveSnapshot* snap){
+	free(snap->tmp_path);
+	free(snap->data);
+	free(snap);
+}
+
+// creates the temp file for a background save. Journal appends from now on go into a new journal on top of it.
+static SaveSnapshot* util_snapshot_begin(Module* m){
+	SaveSnapshot* snap = calloc(1, sizeof(*snap));
+	snap->tmp_fd = -1;
+	snap->pidfd  = -1;
+
+	struct stat st;
+
+	if(asprintf(&snap->tmp_path, "%s.XXXXXX", core_get_datafile()) == -1){
+		snap->tmp_path = NULL;
+	}
+
+	if(!snap->tmp_path || (snap->tmp_fd = mkstemp(snap->tmp_path)) == -1 || fstat(snap->tmp_fd, &st) == -1){
+		fprintf(stderr, "Error saving file for %s: %s\n", m->ctx->name, strerror(errno));
+		if(snap->tmp_fd != -1){
+			close(snap->tmp_fd);
+			unlink(snap->tmp_path);
+		}
+		util_snapshot_free(snap);
+		return NULL;
+	}
+
+	snap->tmp_ino = st.st_ino;
+	m->snapshot = snap;
+
+	util_journal_close(m);
+	snap->gen = m->journal.gen + 1;
+
+	return snap;
+}
+
+static void util_module_bgsave_cb(int id, void* arg);
+static void util_module_save(Module* m);
+
+static void util_snapshot_finish(Module* m, SaveSnapshot* snap){
+	m->snapshot = NULL;
+	sb_push(mod_call_stack, m);
+
+	inotify.data.wd = inotify_add_watch(inotify.fd, inotify.data.path, IN_DELETE_SELF);
+
+	bool saved = false;
+
+	if(!snap->ok){
+		fprintf(stderr, "Error saving file for %s in the background.\n", m->ctx->name);
+		unlink(snap->tmp_path);
+	} else if(rename(snap->tmp_path, core_get_datafile()) < 0){
+		fprintf(stderr, "Error saving file for %s: %s\n", m->ctx->name, strerror(errno));
+		unlink(snap->tmp_path);
+	} else {
+		util_journal_remove(m, snap->gen);
+		saved = true;
+	}
+
+	inotify.data.wd = inotify_add_watch(inotify.fd, inotify.data.path, IN_CLOSE_WRITE | IN_MOVED_TO);
+	sb_pop(mod_call_stack);
+	util_snapshot_free(snap);
+
+	// the journal written since the snapshot began sits on top of a file that never appeared, so save normally instead
+	if(!saved){
+		util_module_save(m);
+	}
+
+	// save_me was called while this one was being written
+	if(m->save_pending && !m->save_timer){
+		m->save_timer = util_timer_add(0, 0, m->ctx, &util_module_bgsave_cb, NULL);
+	}
+}
+
+static void util_snapshot_cancel(Module* m){
+	SaveSnapshot* snap = m->snapshot;
+	if(!snap) return;
+
+	m->snapshot = NULL;
+	unlink(snap->tmp_path);
+
+	// a worker thread might still be writing to it, util_journal_compact_done frees it in that case.
+	if(snap->pid <= 0) return;
+
+	kill(snap->pid, SIGKILL);
+	waitpid(snap->pid, NULL, 0);
+	if(snap->pidfd != -1){
+		util_fd_watch(snap->pidfd, 0, NULL, NULL, NULL);
+		close(snap->pidfd);
+	}
+	util_snapshot_free(snap);
+}
+
+static void util_journal_compact_work(void* arg){
+	SaveSnapshot* snap = arg;
+	snap->ok = util_write_all(snap->tmp_fd, snap->data, snap->data_len) && fsync(snap->tmp_fd) == 0;
+	close(snap->tmp_fd);
+}
+
+static void util_journal_compact_done(void* arg){
+	SaveSnapshot* snap = arg;
+
+	for(Module* m = irc_modules; m < sb_end(irc_modules); ++m){
+		if(m->snapshot == snap){
+			util_snapshot_finish(m, snap);
+			return;
+		}
+	}
+
+	util_snapshot_free(snap);
+}
+
+static void util_async_run(IRCModuleCtx* owner, void (*work)(void*), void (*done)(void*), void* arg, bool cancel_done);
+
+// runs from a timer rather than straight from journal_append, so that the module has finished
+// applying whatever it just appended before its state is saved.
+static void util_journal_compact_cb(int id, void* arg){
+	Module* m = sb_last(mod_call_stack);
+	m->journal.compact_timer = 0;
+
+	if(m->snapshot || m->journal.fd == -1 || !m->ctx->on_save) return;
+
+	// serialising has to happen here, but writing + syncing it can be done on a worker thread.
+	char*  data = NULL;
+	size_t data_len = 0;
+
+	FILE* f = open_memstream(&data, &data_len);
+	bool saved = f && m->ctx->on_save(f);
+	if(f) fclose(f);
+
+	SaveSnapshot* snap;
+
+	if(!saved || !(snap = util_snapshot_begin(m))){
+		fprintf(stderr, "Couldn't compact journal for %s.\n", m->ctx->name);
+		free(data);
+		return;
+	}
+
+	snap->data     = data;
+	snap->data_len = data_len;
+
+	util_async_run(NULL, &util_journal_compact_work, &util_journal_compact_done, snap, false);
+}
+
+static void util_bgsave_fd_cb(int fd, int events, void* arg){
+	SaveSnapshot* snap = arg;
+	int status;
+
+	if(waitpid(snap->pid, &status, WNOHANG) <= 0) return;
+
+	util_fd_watch(fd, 0, NULL, NULL, NULL);
+	close(fd);
+
+	snap->ok = WIFEXITED(status) && WEXITSTATUS(status) == 0;
+
+	for(Module* m = irc_modules; m < sb_end(irc_modules); ++m){
+		if(m->snapshot == snap){
+			util_snapshot_finish(m, snap);
+			return;
+		}
+	}
+
+	util_snapshot_free(snap);
+}
+
+// INSOBOT_BG_SAVE: forks, and lets the child write the data file from its copy-on-write snapshot of the module.
+// save_me calls that happen before it's done are coalesced into one more save afterwards.
+static void util_module_bgsave_cb(int id, void* arg){
+	Module* m = sb_last(mod_call_stack);
+	m->save_timer = 0;
+
+	// util_snapshot_finish will come back here when the current one is done
+	if(m->snapshot) return;
+	m->save_pending = false;
+
+	SaveSnapshot* snap = util_snapshot_begin(m);
+	if(!snap){
+		util_module_save(m);
+		return;
+	}
+
+	pid_t pid = fork();
+
+	if(pid == 0){
+		prctl(PR_SET_NAME, "ib-save");
+		prctl(PR_SET_PDEATHSIG, SIGKILL);
+
+		FILE* f = fdopen(snap->tmp_fd, "wb");
+		bool ok = f && m->ctx->on_save(f) && fflush(f) == 0 && fsync(snap->tmp_fd) == 0;
+		_exit(ok ? 0 : 1);
+	}
+
+	close(snap->tmp_fd);
+	snap->tmp_fd = -1;
+
+	if(pid == -1){
+		perror("bg save: fork");
+		m->snapshot = NULL;
+		unlink(snap->tmp_path);
+		util_snapshot_free(snap);
+		util_module_save(m);
+		return;
+	}
+
+	snap->pid = pid;
+
+	if((snap->pidfd = syscall(SYS_pidfd_open, pid, 0)) == -1){
+		perror("bg save: pidfd_open");
+		util_snapshot_cancel(m);
+		util_module_save(m);
+		return;
+	}
+
+	util_fd_watch(snap->pidfd, IRC_FD_READ, NULL, &util_bgsave_fd_cb, snap);
+}
+
+static void util_module_save(Module* m){
+	if(!m->ctx || !m->ctx->on_save) return;
+
+	// a full save supersedes any background one still being written
+	util_snapshot_cancel(m);
+	m->save_pending = false;
+
+	// change the inotify data watch to something we don't care about to disable it temporarily
+	inotify.data.wd = inotify_add_watch(inotify.fd, inotify.data.path, IN_DELETE_SELF);
+
+	sb_push(mod_call_stack, m);
+
+	const char*  save_fname = core_get_datafile();
+	const size_t save_fsz   = strlen(save_fname);
+	const char   tmp_end[]  = ".XXXXXX";
+	char*        tmp_fname  = alloca(save_fsz + sizeof(tmp_end));
+
+	memcpy(tmp_fname, save_fname, save_fsz);
+	memcpy(tmp_fname + save_fsz, tmp_end, sizeof(tmp_end));
+
+	int tmp_fd = mkstemp(tmp_fname);
+	if(tmp_fd < 0){
+		fprintf(stderr, "Error saving file for %s: %s\n", m->ctx->name, strerror(errno));
+	} else {
+		FILE* tmp_file = fdopen(tmp_fd, "wb");
+		bool saved = m->ctx->on_save(tmp_file);
+		fclose(tmp_file);
+
+		if(saved && rename(tmp_fname, save_fname) < 0){
+			fprintf(stderr, "Error saving file for %s: %s\n", m->ctx->name, strerror(errno));
+		} else if(!saved){
+			unlink(tmp_fname);
+		} else {
+			// everything in the journal is in the data file now
+			util_journal_remove(m, UINT32_MAX);
+		}
+	}
+
+	sb_pop(mod_call_stack);
+
+	inotify.data.wd = inotify_add_watch(inotify.fd, inotify.data.path, IN_CLOSE_WRITE | IN_MOVED_TO);
+}
+
+static Module* util_module_get(const char* name, int type){
+	for(Module* m = irc_modules; m < sb_end(irc_modules); ++m){
+		const char* base_path = basename(m->lib_path);
+		const char* comparison
+			= (type == MOD_GET_CTXNAME)	? m->ctx->name
+			: (type == MOD_GET_SONAME)  ? base_path
+			: NULL;
+
+		if(strcmp(name, comparison) == 0){
+			return m;
+		}
+	}
+	return NULL;
+}
+
+static int util_mod_sort(const void* a, const void* b){
+	return ((Module*)b)->ctx->priority - ((Module*)a)->ctx->priority;
+}
+
+static void util_module_export(Module* m){
+	if(!MOD_HAS_CB(m, on_export_state)) return;
+
+	size_t   len     = 0;
+	uint32_t version = 0;
+	void*    state   = IRC_MOD_CALL(m, on_export_state, (&len, &version));
+
+	if(!state) return;
+
+	m->state         = state;
+	m->state_len     = len;
+	m->state_version = version;
+}
+
+static int64_t util_startup_ms(void){
+	return util_mono_ms() - startup_ms;
+}
+
+// calls on_quit and releases everything the module owns. a threaded on_init has to finish first.
+static void util_module_quit(Module* m){
+	if(m->init_state == MOD_INIT_PENDING){
+		// released first so that a threaded on_init has finished before on_quit runs
+		util_release_owned(m->ctx);
+		if(!m->init_job || m->init_job->ok){
+			IRC_MOD_CALL(m, on_quit, ());
+		}
+	} else {
+		if(m->init_state == MOD_INIT_READY){
+			IRC_MOD_CALL(m, on_quit, ());
+		}
+		util_release_owned(m->ctx);
+	}
+
+	free(m->init_job);
+	m->init_job = NULL;
+}
+
+static void util_module_remove(Module* m){
+	util_module_quit(m);
+	util_stats_free(m);
+	dlclose(m->lib_handle);
+	m->lib_handle = NULL;
+	free(m->lib_path);
+	sb_erase(irc_modules, m - irc_modules);
+	mod_subs_dirty = true;
+	mod_list_dirty = true;
+}
+
+// tells a module that just became ready about what it missed
+static void util_module_replay(Module* m){
+	if(irc_conn.state == IRC_STATE_CONNECTED){
+		IRC_MOD_CALL(m, on_connect, (serv));
+	}
+
+	for(char** c = channels; *c; ++c){
+		IRCChan* chan = util_chan_find(*c);
+
+		IRC_MOD_CALL(m, on_join, (*c, bot_nick));
+		util_mod_names(m, *c, (const char**)chan->nicks, sb_count(chan->nicks));
+	}
+}
+
+static int util_timeline_sort(const void* a, const void* b){
+	const ModTimeline* x = &(*(Module**)a)->timeline;
+	const ModTimeline* y = &(*(Module**)b)->timeline;
+	return (y->init_end - y->init_start) - (x->init_end - x->init_start);
+}
+
+// prints when each module was loaded, initialized and became ready, once they all have after starting up
+static void util_startup_report(void){
+	if(startup_reported) return;
+
+	for(Module* m = irc_modules; m < sb_end(irc_modules); ++m){
+		if(m->init_state == MOD_INIT_PENDING) return;
+	}
+
+	startup_reported = true;
+
+	Module** order = NULL;
+	for(Module* m = irc_modules; m < sb_end(irc_modules); ++m){
+		sb_push(order, m);
+	}
+	qsort(order, sb_count(order), sizeof(*order), &util_timeline_sort);
+
+	printf("Startup timeline (ms, slowest init first):\n");
+	printf("  %-20s %13s %13s %6s  %s\n", "module", "load", "init", "ready", "mode");
+
+	for(Module** o = order; o < sb_end(order); ++o){
+		const ModTimeline* t = &(*o)->timeline;
+		printf(
+			"  %-20s %6" PRId64 " +%-5" PRId64 " %6" PRId64 " +%-5" PRId64 " %6" PRId64 "  %s%s\n",
+			(*o)->ctx->name,
+			t->load_start, t->load_end - t->load_start,
+			t->init_start, t->init_end - t->init_start,
+			t->ready,
+			t->mode,
+			(*o)->init_state == MOD_INIT_FAILED ? " (failed)" : ""
+		);
+	}
+
+	printf("All modules ready after %" PRId64 "ms.\n", util_startup_ms());
+	sb_free(order);
+}
+
+static void util_module_reap_cb(int id, void* arg){
+	mod_reap_timer = 0;
+
+	for(Module* m = irc_modules; m < sb_end(irc_modules); ++m){
+		if(m->init_state != MOD_INIT_FAILED) continue;
+		util_module_remove(m);
+		--m;
+	}
+
+	util_cmd_index_build();
+}
+
+// a module's on_init finished on a worker, or it called init_done
+static void util_module_init_finish(Module* m, bool ok){
+	if(m->init_state != MOD_INIT_PENDING) return;
+
+	m->init_state     = ok ? MOD_INIT_READY : MOD_INIT_FAILED;
+	m->timeline.ready = util_startup_ms();
+
+	// util_reload_modules takes care of the rest when it happens during it
+	if(mod_reloading) return;
+
+	const char* mod_name = basename(m->lib_path);
+
+	if(ok){
+		printf("%s is ready.\n", mod_name);
+		mod_subs_dirty = true;
+		mod_list_dirty = true;
+		util_cmd_index_build();
+		util_module_replay(m);
+	} else {
+		printf("** Init failed for %s.\n", mod_name);
+		if(!mod_reap_timer){
+			mod_reap_timer = util_timer_add(0, 0, NULL, &util_module_reap_cb, NULL);
+		}
+	}
+
+	util_startup_report();
+}
+
+// runs on an async worker thread, so can't touch anything but the job
+static void util_module_init_work(void* arg){
+	ModInitJob* job = arg;
+	const int64_t start = util_stats_now();
+
+	job->start = util_startup_ms();
+	job->ok    = job->ctx->on_init && job->ctx->on_init(job->core_ctx);
+	job->end   = util_startup_ms();
+	job->ns    = util_stats_now() - start;
+}
+
+static void util_module_init_done(void* arg){
+	ModInitJob* job = arg;
+	Module* m = util_module_from_ctx(job->ctx);
+
+	m->init_job = NULL;
+	m->timeline.init_start = job->start;
+	m->timeline.init_end   = job->end;
+	util_stats_add(m, MOD_CB_SLOT(on_init), job->ns);
+	util_module_init_finish(m, job->ok);
+
+	free(job);
+}
+
+static void util_reload_modules(const IRCCoreCtx* core_ctx){
+
+	for(Module* m = irc_modules; m < sb_end(irc_modules); ++m){
+		if(!m->needs_reload) continue;
+		mod_list_dirty = true;
+
+		const char* mod_name = basename(m->lib_path);
+
+		if(m->lib_handle){
+			// a module that isn't ready hasn't loaded anything that could be saved
+			if(m->init_state == MOD_INIT_READY){
+				// saved even if the state is handed over, in case the new .so doesn't load or doesn't take it
+				util_module_save(m);
+				util_module_export(m);
+			}
+
+			util_module_quit(m);
+			util_journal_close(m);
+			util_stats_free(m); // the new code starts from scratch
+			m->journal.compact_timer = m->save_timer = 0;
+			dlclose(m->lib_handle);
+			m->lib_handle = NULL;
+		}
+
+		m->init_state = MOD_INIT_READY;
+		m->timeline   = (ModTimeline){ .load_start = util_startup_ms() };
+
+		dlerror();
+		m->lib_handle = dlopen(m->lib_path, RTLD_LAZY | RTLD_LOCAL);
+		mod_subs_dirty = true;
+
+		printf("Loading module %-20s", mod_name);
+
+		const char* errmsg = dlerror();
+		if(!errmsg && m->lib_handle){
+			m->ctx = dlsym(m->lib_handle, "irc_mod_ctx");
+			errmsg = dlerror();
+		} else if(!errmsg && !m->lib_handle){
+			errmsg = "NULL lib handle.";
+		}
+
+		if(!errmsg){
+			const ElfW(Sym)* sym = NULL;
+			Dl_info unused;
+			if(dladdr1(m->ctx, &unused, (void**)&sym, RTLD_DL_SYMENT) == 0){
+				errmsg = "dladdr1 failed.";
+			} else if(sym->st_size < (sizeof(void*)*23)) {
+				
+				// NOTE: ABI Table for IRCModuleCtx:
+				//
+				//       | sizeof(void*) | last field      |
+				//       +---------------+-----------------+
+				//       |      x23      | on_ipc          |
+				//       |      x24      | on_filter       |
+				//       |      x25      | on_unknown      |
+				//       |      x26      | on_names        |
+				//       |      x27      | on_twitch       |
+				//       |      x29      | on_import_state |
+
+				errmsg = "version mismatch (wrong size irc_mod_ctx)";
+			} else {
+				m->ctx_size = sym->st_size;
+				m->ipc_id   = util_ipc_mod_id(m->ctx->name);
+			}
+		}
+
+		if(errmsg){
+			puts("");
+			fprintf(stderr, "** Error loading module %s:\n  %s\n", mod_name, errmsg);
+			if(m->lib_handle){
+				dlclose(m->lib_handle);
+				m->lib_handle = NULL;
+			}
+			free(m->lib_path);
+			free(m->state);
+			sb_erase(irc_modules, m - irc_modules);
+			mod_subs_dirty = true;
+			--m;
+			continue;
+		} else {
+			struct link_map* mod_info = m->lib_handle;
+			printf("[0x%zx]\n", (size_t)mod_info->l_addr);
+			m->timeline.load_end = util_startup_ms();
+		}
+	}
+
+	mod_reloading = true;
+
+	for(Module* m = irc_modules; m < sb_end(irc_modules); ++m){
+		if(!m->needs_reload) continue;
+		m->needs_reload = false;
+
+		const char* mod_name = basename(m->lib_path);
+		m->timeline.init_start = util_startup_ms();
+
+		if(m->state){
+			bool imported = MOD_HAS_CB(m, on_import_state) && IRC_MOD_CALL(m, on_import_state, (core_ctx, m->state, m->state_len, m->state_version));
+
+			free(m->state);
+			m->state = NULL;
+
+			if(imported){
+				printf("Imported state for %s.\n", mod_name);
+				m->timeline.init_end = m->timeline.ready = util_startup_ms();
+				m->timeline.mode     = "import";
+				continue;
+			}
+
+			printf("%s didn't import its state.\n", mod_name);
+		}
+
+		printf("Init %s...\n", mod_name);
+
+		// threaded on_inits run alongside the rest, and the module becomes ready when util_module_init_done is called
+		if(m->ctx->flags & IRC_MOD_INIT_THREAD){
+			ModInitJob* job = malloc(sizeof(*job));
+			*job = (ModInitJob){
+				.core_ctx = core_ctx,
+				.ctx      = m->ctx,
+			};
+
+			m->init_state    = MOD_INIT_PENDING;
+			m->init_job      = job;
+			m->timeline.mode = "thread";
+
+			// if there are no worker threads this runs it right away, and util_module_init_finish leaves the rest to us
+			// util_module_quit takes care of the job if the module is unloaded before it's done
+			util_async_run(m->ctx, &util_module_init_work, &util_module_init_done, job, false);
+		} else {
+			m->timeline.mode = "sync";
+
+			// core_init_later changes the state & mode if the module calls init_later
+			if(!IRC_MOD_CALL(m, on_init, (core_ctx))){
+				m->init_state = MOD_INIT_FAILED;
+			}
+
+			m->timeline.init_end = util_startup_ms();
+			if(m->init_state == MOD_INIT_READY && !m->timeline.ready){
+				m->timeline.ready = m->timeline.init_end;
+			}
+		}
+
+		if(m->init_state == MOD_INIT_FAILED){
+			printf("** Init failed for %s.\n", mod_name);
+			util_module_remove(m);
+			--m;
+			continue;
+		}
+
+		if(m->init_state == MOD_INIT_PENDING){
+			printf("%s will finish initializing later.\n", mod_name);
+			continue;
+		}
+
+		util_module_replay(m);
+	}
+
+	mod_reloading = false;
+
+	qsort(irc_modules, sb_count(irc_modules), sizeof(*irc_modules), &util_mod_sort);
+	util_mod_subs_build();
+	util_cmd_index_build();
+	util_startup_report();
+}
+
+static void util_inotify_add(INotifyWatch* watch, const char* path, uint32_t flags){
+
+	if(access(path, W_OK) != 0){
+		printf("Creating dir [%s] for inotify.\n", path);
+		if(mkdir(path, 00750) == -1){
+			perror("Error creating dir");
+		}
+	}
+
+	watch->path = strdup(path);
+	watch->wd   = inotify_add_watch(inotify.fd, path, flags);
+}
+
+static void util_inotify_check(const IRCCoreCtx* core_ctx){
+	struct inotify_event* ev;
+	char buff[sizeof(*ev) + NAME_MAX + 1];
+	bool reload = false;
+
+	ssize_t num_read = read(inotify.fd, &buff, sizeof(buff));
+
+	for(char* p = buff; (p - buff) < num_read; p += (sizeof(*ev) + ev->len)){
+		ev = (struct inotify_event*)p;
+
+		if(ev->wd == inotify.module.wd){
+			Module* m = util_module_get(ev->name, MOD_GET_SONAME);
+			if(m){
+				m->needs_reload = true;
+			} else {
+				util_module_add(ev->name);
+			}
+			reload = true;
+		} else if(ev->wd == inotify.data.wd){
+			if(!memmem(ev->name, ev->len, ".data", 6)) continue;
+			fprintf(stderr, "%s was modified.\n", ev->name);
+
+			Module* m = util_module_get(strndupa(ev->name, strlen(ev->name) - 5), MOD_GET_CTXNAME);
+			if(m){
+				m->data_modified = true;
+			}
+		}
+	}
+
+	for(Module* m = irc_modules; m < sb_end(irc_modules); ++m){
+		if(!m->data_modified) continue;
+		m->data_modified = false;
+
+		// it's still loading the data file (or has failed to)
+		if(m->init_state != MOD_INIT_READY) continue;
+
+		// the module will reload the data file, so records on top of the old one are no use
+		sb_push(mod_call_stack, m);
+		util_snapshot_cancel(m);
+		util_journal_remove(m, UINT32_MAX);
+		sb_pop(mod_call_stack);
+
+		fprintf(stderr, "Calling on_data_modified for %s\n", m->ctx->name);
+		IRC_MOD_CALL(m, on_modified, ());
+	}
+
+	if(reload){
+		util_reload_modules(core_ctx);
+	}
+}
+
+static void util_ipc_ring_doorbell(void){
+	__atomic_add_fetch(&ipc_ring->doorbell, 1, __ATOMIC_RELEASE);
+	syscall(SYS_futex, &ipc_ring->doorbell, FUTEX_WAKE, INT_MAX, NULL, NULL, 0);
+}
+
+// waits on the ring's futex, and pokes the main loop through ipc_eventfd when it changes
+static void* util_ipc_thread(void* arg){
+	uint32_t seen = __atomic_load_n(&ipc_ring->doorbell, __ATOMIC_ACQUIRE);
+	uint64_t one = 1;
+
+	// anything written before we started waiting would otherwise be missed
+	if(write(ipc_eventfd, &one, sizeof(one)) == -1 && errno != EAGAIN){
+		perror("ipc: eventfd write");
+	}
+
+	while(!__atomic_load_n(&ipc_quit, __ATOMIC_ACQUIRE)){
+		syscall(SYS_futex, &ipc_ring->doorbell, FUTEX_WAIT, seen, NULL, NULL, 0);
+
+		uint32_t now = __atomic_load_n(&ipc_ring->doorbell, __ATOMIC_ACQUIRE);
+		if(now != seen){
+			seen = now;
+			if(write(ipc_eventfd, &one, sizeof(one)) == -1 && errno != EAGAIN){
+				perror("ipc: eventfd write");
+			}
+		}
+	}
+
+	return NULL;
+}
+
+static void util_ipc_init(void){
+	char ipc_path[PATH_MAX];
+	struct stat st;
+
+	// get dir to store the ipc ring
+
+	const char* ipc_dir_prefix   = getenv("XDG_RUNTIME_DIR");
+	const char  ipc_dir_suffix[] = "/insobot/";
+
+	if(!ipc_dir_prefix || stat(ipc_dir_prefix, &st) == -1 || !S_ISDIR(st.st_mode) || access(ipc_dir_prefix, W_OK) == -1){
+		ipc_dir_prefix = "/run/shm";
+	}
+
+	if(snprintf(ipc_path, sizeof(ipc_path), "%s%s", ipc_dir_prefix, ipc_dir_suffix) >= (int)sizeof(ipc_path) - 8){
+		fprintf(stderr, "IPC dir name too long!");
+		return;
+	}
+
+	if(stat(ipc_path, &st) == -1){
+		if(mkdir(ipc_path, 0777) == -1){
+			perror("ipc_init: mkdir");
+		}
+	}
+
+	strcat(ipc_path, "ring");
+
+	// open or create the ring, the lock stops two instances initializing it at once
+
+	int fd = open(ipc_path, O_RDWR | O_CREAT | O_CLOEXEC, 0600);
+	if(fd == -1){
+		perror("ipc_init: open");
+		return;
+	}
+
+	const size_t map_size = sizeof(IPCRing) + IPC_RING_SIZE;
+	flock(fd, LOCK_EX);
+
+	if(fstat(fd, &st) == -1 || (st.st_size != (off_t)map_size && ftruncate(fd, map_size) == -1)){
+		perror("ipc_init: ftruncate");
+		flock(fd, LOCK_UN);
+		close(fd);
+		return;
+	}
+
+	IPCRing* ring = mmap(NULL, map_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+
+	if(ring != MAP_FAILED && (ring->magic != IPC_RING_MAGIC || ring->version != IPC_RING_VERSION || ring->size != IPC_RING_SIZE)){
+		memset(ring, 0, sizeof(*ring));
+		ring->version = IPC_RING_VERSION;
+		ring->size    = IPC_RING_SIZE;
+		__atomic_store_n(&ring->magic, IPC_RING_MAGIC, __ATOMIC_RELEASE);
+	}
+
+	flock(fd, LOCK_UN);
+	close(fd);
+
+	if(ring == MAP_FAILED){
+		perror("ipc_init: mmap");
+		return;
+	}
+
+	printf("IPC ring: %s\n", ipc_path);
+
+	if((ipc_eventfd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC)) == -1){
+		perror("ipc_init: eventfd");
+		munmap(ring, map_size);
+		return;
+	}
+
+	ipc_ring     = ring;
+	ipc_read_pos = __atomic_load_n(&ring->head, __ATOMIC_ACQUIRE);
+
+	if(pthread_create(&ipc_thread, NULL, &util_ipc_thread, NULL) != 0){
+		fputs("ipc_init: couldn't start thread\n", stderr);
+		close(ipc_eventfd);
+		ipc_eventfd = -1;
+		munmap(ring, map_size);
+		ipc_ring = NULL;
+	}
+}
+
+static void util_ipc_quit(void){
+	if(!ipc_ring) return;
+
+	__atomic_store_n(&ipc_quit, true, __ATOMIC_RELEASE);
+	syscall(SYS_futex, &ipc_ring->doorbell, FUTEX_WAKE, INT_MAX, NULL, NULL, 0);
+	pthread_join(ipc_thread, NULL);
+
+	util_fd_watch(ipc_eventfd, 0, NULL, NULL, NULL);
+	close(ipc_eventfd);
+	munmap(ipc_ring, sizeof(IPCRing) + IPC_RING_SIZE);
+	ipc_ring = NULL;
+
+	sb_free(ipc_recv_buf);
+}
+
+// writes a message into the ring with a single reservation, so a broadcast is only written once
+static bool util_ipc_write(uint32_t mod_id, int target, const void* data, size_t data_len){
+	const uint64_t size = ipc_ring->size;
+	const uint64_t need = (sizeof(IPCRecord) + data_len + 7) & ~7ULL;
+
+	if(need > size / 4){
+		fprintf(stderr, "IPC msg too big (%zu bytes).\n", data_len);
+		return false;
+	}
+
+	uint64_t old = __atomic_load_n(&ipc_ring->head, __ATOMIC_RELAXED), start;
+	do {
+		// don't let a record wrap around, skip to the start of the ring instead
+		start = old;
+		if(size - (start % size) < need){
+			start += size - (start % size);
+		}
+	} while(!__atomic_compare_exchange_n(&ipc_ring->head, &old, start + need, true, __ATOMIC_ACQ_REL, __ATOMIC_RELAXED));
+
+	// mark the skipped space as padding, if there's room for a header. if there isn't, readers skip it anyway.
+	if(start != old && size - (old % size) >= sizeof(IPCRecord)){
+		IPCRecord* pad = (IPCRecord*)(ipc_ring->data + old % size);
+		pad->len      = start - old;
+		pad->data_len = 0;
+		pad->mod_id   = 0;
+		__atomic_store_n(&pad->pos, old, __ATOMIC_RELEASE);
+	}
+
+	IPCRecord* rec = (IPCRecord*)(ipc_ring->data + start % size);
+
+	// readers can skip it using len if we die while writing it
+	rec->len = need;
+	__atomic_store_n(&rec->pos, ~start, __ATOMIC_RELEASE);
+
+	rec->data_len = data_len;
+	rec->sender   = getpid();
+	rec->target   = target;
+	rec->mod_id   = mod_id;
+	memcpy(rec + 1, data, data_len);
+
+	__atomic_store_n(&rec->pos, start, __ATOMIC_RELEASE);
+
+	util_ipc_ring_doorbell();
+
+	return true;
+}
+
+static void util_ipc_recv(void);
+
+static void util_ipc_stall_cb(int id, void* arg){
+	ipc_stall_timer = 0;
+	util_ipc_recv();
+}
+
+static void util_ipc_recv(void){
+	if(!ipc_ring) return;
+
+	const uint64_t size = ipc_ring->size;
+	const pid_t    self = getpid();
+
+	for(;;){
+		const uint64_t head = __atomic_load_n(&ipc_ring->head, __ATOMIC_ACQUIRE);
+
+		if(ipc_read_pos == head) break;
+
+		if(head - ipc_read_pos > size){
+			fprintf(stderr, "IPC: fell behind, skipped %" PRIu64 " bytes.\n", head - ipc_read_pos);
+			ipc_read_pos = head;
+			ipc_stall_ms = 0;
+			break;
+		}
+
+		const uint64_t off = ipc_read_pos % size;
+		if(size - off < sizeof(IPCRecord)){
+			ipc_read_pos += size - off;
+			continue;
+		}
+
+		IPCRecord* rec = (IPCRecord*)(ipc_ring->data + off);
+		const uint64_t pos = __atomic_load_n(&rec->pos, __ATOMIC_ACQUIRE);
+
+		// another instance is still writing it, wait a bit, but don't get stuck on it forever
+		if(pos != ipc_read_pos){
+			const int64_t now = util_mono_ms();
+
+			if(!ipc_stall_ms){
+				ipc_stall_ms = now;
+			} else if(now - ipc_stall_ms >= IPC_STALL_MS){
+				ipc_stall_ms = 0;
+				if(pos == ~ipc_read_pos && rec->len >= sizeof(IPCRecord) && rec->len <= size - off){
+					fputs("IPC: skipping unfinished msg.\n", stderr);
+					ipc_read_pos += rec->len;
+				} else {
+					fputs("IPC: ring is corrupt, skipping to the end.\n", stderr);
+					ipc_read_pos = head;
+				}
+				continue;
+			}
+
+			if(!ipc_stall_timer){
+				ipc_stall_timer = util_timer_add(IPC_STALL_MS, 0, NULL, &util_ipc_stall_cb, NULL);
+			}
+			break;
+		}
+
+		ipc_stall_ms = 0;
+
+		IPCRecord r = *rec;
+		if(r.len < sizeof(IPCRecord) || r.len > size - off || r.data_len > r.len - sizeof(IPCRecord)){
+			fputs("IPC: bad msg header, skipping to the end.\n", stderr);
+			ipc_read_pos = head;
+			break;
+		}
+
+		if(!r.mod_id || r.sender == self || (r.target != 0 && r.target != self)){
+			ipc_read_pos += r.len;
+			continue;
+		}
+
+		// copy it out, since the module's callback might take long enough for it to be overwritten
+		if(ipc_recv_buf) stb__sbn(ipc_recv_buf) = 0;
+		memcpy(sb_add(ipc_recv_buf, r.data_len + 1), rec + 1, r.data_len);
+
+		if(__atomic_load_n(&ipc_ring->head, __ATOMIC_ACQUIRE) - ipc_read_pos > size){
+			continue;
+		}
+
+		ipc_read_pos += r.len;
+
+		for(Module **sub = util_mod_subs(MOD_CB_SLOT(on_ipc)), **sub_end = sb_end(sub); sub < sub_end; ++sub){
+			Module* m = *sub;
+			if(m->ipc_id != r.mod_id) continue;
+
+			util_log(IRC_LOG_DEBUG, "Got IPC msg from %d for %s\n", r.sender, m->ctx->name);
+			IRC_MOD_CALL(m, on_ipc, (r.sender, ipc_recv_buf, r.data_len));
+		}
+	}
+}
+
+static void util_trim_end_spaces(char* msg, size_t len){
+	if(len > 0){
+		for(char* p = msg + len - 1; p >= msg && *p == ' '; --p){
+			*p = 0;
+		}
+	}
+}
+
+static uint32_t util_tag_hash(const char* key){
+	uint32_t hash = 2166136261u;
+	for(; *key; ++key){
+		hash ^= (uint8_t)*key;
+		hash *= 16777619u;
+	}
+	return hash;
+}
+
+// splits and unescapes the tags in one pass, in place in the input buffer
+static void util_parse_tags(void){
+	irc_tags_parsed = true;
+
+	if(irc_tag_ptrs)  stb__sbn(irc_tag_ptrs) = 0;
+
+	if(!irc_tag_raw) return;
+
+	const char* r = irc_tag_raw;
+	char*       w = irc_tag_raw;
+
+	while(*r){
+		char* k = w;
+		while(*r && *r != '=' && *r != ';') *w++ = *r++;
+
+		// w never gets ahead of r, so check what ended the key before terminating it
+		const bool has_value = *r == '=';
+		if(*r) ++r;
+		*w++ = '\0';
+
+		char* v = w - 1;
+
+		if(has_value){
+			v = w;
+
+			for(; *r && *r != ';'; ++r){
+				if(*r != '\\'){
+					*w++ = *r;
+					continue;
+				}
+
+				switch(*++r){
+					case ':':  *w++ = ';';  break;
+					case 's':  *w++ = ' ';  break;
+					case 'r':  *w++ = '\r'; break;
+					case 'n':  *w++ = '\n'; break;
+					case '\0': --r;         break; // trailing backslash is dropped
+					default:   *w++ = *r;   break;
+				}
+			}
+
+			if(*r) ++r;
+			*w++ = '\0';
+		}
+
+		if(*k){
+			sb_push(irc_tag_ptrs, k);
+			sb_push(irc_tag_ptrs, v);
+		}
+	}
+
+	// index the keys, keeping the first of any duplicates
+	const size_t num_tags = sb_count(irc_tag_ptrs) / 2;
+
+	size_t index_size = 32;
+	while(index_size < num_tags * 2) index_size *= 2;
+
+	if(sb_count(irc_tag_index) < index_size){
+		(void)sb_add(irc_tag_index, index_size - sb_count(irc_tag_index));
+	}
+	stb__sbn(irc_tag_index) = index_size;
+	memset(irc_tag_index, 0, index_size * sizeof(int));
+
+	for(size_t i = 0; i < num_tags; ++i){
+		const char* key = irc_tag_ptrs[i*2];
+		size_t slot = util_tag_hash(key) & (index_size - 1);
+
+		while(irc_tag_index[slot] && strcmp(irc_tag_ptrs[(irc_tag_index[slot] - 1) * 2], key) != 0){
+			slot = (slot + 1) & (index_size - 1);
+		}
+		if(!irc_tag_index[slot]){
+			irc_tag_index[slot] = i + 1;
+		}
+	}
+}
+
+static void util_stdin_cb(int fd, int events, void* arg){
+	char stdin_buf[1024];
+	ssize_t n = read(fd, stdin_buf, sizeof(stdin_buf));
+
+	if(n > 0){
+		stdin_buf[n-1] = 0; // remove \n
+		IRC_MOD_CALL_ALL(on_stdin, (stdin_buf));
+	} else if(n == 0){
+		// EOF, stop watching it so we don't spin
+		util_fd_watch(fd, 0, NULL, NULL, NULL);
+	}
+}
+
+static void util_ipc_cb(int fd, int events, void* arg){
+	uint64_t count;
+	if(read(fd, &count, sizeof(count)) == -1 && errno != EAGAIN){
+		perror("ipc: eventfd read");
+	}
+
+	util_ipc_recv();
+}
+
+static void util_inotify_cb(int fd, int events, void* arg){
+	util_inotify_check(arg);
+}
+
+static void util_debug_pipe_cb(int fd, int events, void* arg){
+	char buf[256];
+	char* fname;
+	int off;
+	ssize_t n = read(fd, buf, sizeof(buf)-1);
+
+	if(n > 0){
+		buf[n] = 0;
+		if(sscanf(buf, "%m[^(]%n", &fname, &off) == 1){
+			buf[n-1] = 0; // remove \n
+			core_send_msg(debug_chan, "Recovered from crash: %s%s", basename(fname), buf + off);
+			free(fname);
+		}
+	}
+}
+
+static void util_irc_disconnect(void){
+	if(irc_conn.ssl){
+		SSL_free(irc_conn.ssl);
+		irc_conn.ssl = NULL;
+	}
+
+	if(irc_conn.fd != -1){
+		util_fd_watch(irc_conn.fd, 0, NULL, NULL, NULL);
+		close(irc_conn.fd);
+		irc_conn.fd = -1;
+	}
+
+	if(irc_conn.out) stb__sbn(irc_conn.out) = 0;
+	irc_conn.out_off = 0;
+	irc_conn.in_len  = 0;
+	irc_conn.ssl_want_write = false;
+	irc_conn.state   = IRC_STATE_DISCONNECTED;
+}
+
+// logs the openssl error for a failed SSL_* call, returns true if it just needs to be retried later
+static bool util_irc_ssl_retry(int ret, const char* what){
+	int err = SSL_get_error(irc_conn.ssl, ret);
+
+	if(err == SSL_ERROR_WANT_READ){
+		return true;
+	} else if(err == SSL_ERROR_WANT_WRITE){
+		irc_conn.ssl_want_write = true;
+		return true;
+	}
+
+	if(err == SSL_ERROR_SYSCALL && errno){
+		fprintf(stderr, "%s: %s\n", what, strerror(errno));
+	} else if(err != SSL_ERROR_ZERO_RETURN){
+		fprintf(stderr, "%s: %s\n", what, ERR_reason_error_string(ERR_get_error()));
+	}
+
+	return false;
+}
+
+// writes as much of the pending output as the socket will take
+static void util_irc_flush(void){
+	if(irc_conn.state < IRC_STATE_REGISTERING) return;
+
+	while(irc_conn.out_off < sb_count(irc_conn.out)){
+		const char* buf = irc_conn.out + irc_conn.out_off;
+		size_t      len = sb_count(irc_conn.out) - irc_conn.out_off;
+		ssize_t     n;
+
+		if(irc_conn.ssl){
+			irc_conn.ssl_want_write = false;
+			n = SSL_write(irc_conn.ssl, buf, len);
+			if(n <= 0){
+				if(!util_irc_ssl_retry(n, "SSL_write")) util_irc_disconnect();
+				break;
+			}
+		} else {
+			n = send(irc_conn.fd, buf, len, MSG_NOSIGNAL);
+			if(n < 0){
+				if(errno == EINTR) continue;
+				if(errno != EAGAIN && errno != EWOULDBLOCK){
+					perror("irc send");
+					util_irc_disconnect();
+				}
+				break;
+			}
+		}
+
+		irc_conn.out_off += n;
+	}
+
+	if(irc_conn.out && irc_conn.out_off == sb_count(irc_conn.out)){
+		stb__sbn(irc_conn.out) = 0;
+		irc_conn.out_off = 0;
+	}
+}
+
+// queues a line to be sent to the server (\r\n is added), returns false if the output buffer is full.
+static bool util_irc_send(const char* fmt, ...){
+	char line[IRC_LINE_MAX];
+	va_list va;
+
+	if(irc_conn.state == IRC_STATE_DISCONNECTED){
+		return true;
+	}
+
+	if(util_irc_out_full()){
+		return false;
+	}
+
+	va_start(va, fmt);
+	int len = vsnprintf(line, sizeof(line) - 2, fmt, va);
+	va_end(va);
+
+	if(len < 0) return true;
+	len = INSO_MIN(len, (int)sizeof(line) - 3);
+
+	// a stray newline would let the rest of the line be read as a separate command
+	for(char* p = line; p < line + len; ++p){
+		if(*p == '\r' || *p == '\n') *p = ' ';
+	}
+
+	memcpy(line + len, "\r\n", 2);
+	memcpy(sb_add(irc_conn.out, len + 2), line, len + 2);
+
+	util_irc_flush();
+	return true;
+}
+
+// splits a line into tags, prefix, command & params by writing NULs into it. No copies are made.
+static bool util_irc_parse(char* line, IRCMsg* msg){
+	memset(msg, 0, sizeof(*msg));
+
+	if(*line == '@'){
+		msg->tags = ++line;
+		line += strcspn(line, " ");
+		if(*line) *line++ = '\0';
+		while(*line == ' ') ++line;
+	}
+
+	if(*line == ':'){
+		msg->prefix = ++line;
+		line += strcspn(line, " ");
+		if(*line) *line++ = '\0';
+		while(*line == ' ') ++line;
+	}
+
+	if(!*line) return false;
+
+	msg->cmd = line;
+	line += strcspn(line, " ");
+
+	while(*line){
+		while(*line == ' ') *line++ = '\0';
+		if(!*line) break;
+
+		if(*line == ':' || msg->num_params == IRC_PARAMS_MAX - 1){
+			if(*line == ':') *line++ = '\0';
+			msg->params[msg->num_params++] = line;
+			break;
+		}
+
+		msg->params[msg->num_params++] = line;
+		line += strcspn(line, " ");
+	}
+
+	return true;
+}
+
+// indexed by IRC_TWITCH_*
+static const char* twitch_events[] = {
+	"USERNOTICE",
+	"ROOMSTATE",
+	"USERSTATE",
+	"CLEARCHAT",
+	"WHISPER",
+};
+
+static bool util_irc_is_chan(const char* target){
+	return *target && strchr("#&+!", *target);
+}
+
+static void util_irc_dispatch(IRCMsg* msg){
+	const char** params = (const char**)msg->params;
+	const unsigned count = msg->num_params;
+	const char* cmd = msg->cmd;
+
+	// only the nick part of nick!user@host is used
+	char* origin = msg->prefix;
+	if(origin){
+		origin[strcspn(origin, "!@")] = '\0';
+	}
+
+	irc_tag_raw     = msg->tags;
+	irc_tags_parsed = false;
+
+	if(strcmp(cmd, "PRIVMSG") == 0 && count >= 2){
+		char* text = msg->params[1];
+		size_t len = strlen(text);
+
+		if(*text == '\001'){
+			if(len > 1 && text[len-1] == '\001') text[--len] = '\0';
+			++text;
+
+			if(strncmp(text, "ACTION ", 7) == 0){
+				text[6] = '\0';
+				params[1] = text + 7;
+				irc_on_action(cmd, origin, params, count);
+			} else if(origin && (strcmp(text, "VERSION") == 0 || strncmp(text, "PING", 4) == 0)){
+				const char* reply = *text == 'V' ? "VERSION insobot" : text;
+				util_irc_send("NOTICE %s :\001%s\001", origin, reply);
+			}
+		} else if(util_irc_is_chan(params[0])){
+			irc_on_chat_msg(cmd, origin, params, count);
+		} else {
+			irc_on_pm(cmd, origin, params, count);
+		}
+	} else if(strcmp(cmd, "PING") == 0){
+		util_irc_send("PONG :%s", count ? params[0] : serv);
+	} else if(strcmp(cmd, "JOIN") == 0){
+		irc_on_join(cmd, origin, params, count);
+	} else if(strcmp(cmd, "PART") == 0){
+		irc_on_part(cmd, origin, params, count);
+	} else if(strcmp(cmd, "QUIT") == 0){
+		irc_on_quit(cmd, origin, params, count);
+	} else if(strcmp(cmd, "NICK") == 0){
+		irc_on_nick(cmd, origin, params, count);
+	} else if(isdigit(cmd[0]) && isdigit(cmd[1]) && isdigit(cmd[2]) && !cmd[3]){
+		unsigned num = atoi(cmd);
+		if(num == IRC_RPL_WELCOME && irc_conn.state == IRC_STATE_REGISTERING){
+			irc_conn.state = IRC_STATE_CONNECTED;
+			irc_on_connect(cmd, origin, params, count);
+		}
+		irc_on_numeric(num, origin, params, count);
+	} else if(
+		strcmp(cmd, "NOTICE") != 0 && strcmp(cmd, "MODE")   != 0 && strcmp(cmd, "TOPIC") != 0 &&
+		strcmp(cmd, "KICK")   != 0 && strcmp(cmd, "INVITE") != 0
+	){
+		size_t i = 0;
+		while(i < ARRAY_SIZE(twitch_events) && strcmp(cmd, twitch_events[i]) != 0) ++i;
+
+		if(i < ARRAY_SIZE(twitch_events)){
+			irc_on_twitch(i, origin, params, count);
+		} else {
+			irc_on_unknown(cmd, origin, params, count);
+		}
+	}
+
+	// the input buffer is reused after this, so forget any tags that were parsed out of it
+	irc_tag_raw     = NULL;
+	irc_tags_parsed = false;
+}
+
+static void util_irc_read(void){
+	while(irc_conn.state != IRC_STATE_DISCONNECTED){
+		char*   buf   = irc_conn.in + irc_conn.in_len;
+		size_t  space = sizeof(irc_conn.in) - irc_conn.in_len - 1;
+		ssize_t n;
+
+		if(space == 0){
+			fprintf(stderr, "Line from server too long, dropping %zu bytes.\n", irc_conn.in_len);
+			irc_conn.in_len = 0;
+			continue;
+		}
+
+		if(irc_conn.ssl){
+			n = SSL_read(irc_conn.ssl, buf, space);
+			if(n <= 0){
+				if(!util_irc_ssl_retry(n, "SSL_read")){
+					puts("Disconnected from server.");
+					util_irc_disconnect();
+				}
+				return;
+			}
+		} else {
+			n = recv(irc_conn.fd, buf, space, 0);
+			if(n < 0 && errno == EINTR) continue;
+			if(n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) return;
+			if(n <= 0){
+				if(n < 0) perror("irc recv");
+				puts("Disconnected from server.");
+				util_irc_disconnect();
+				return;
+			}
+		}
+
+		irc_conn.in_len += n;
+		irc_conn.in[irc_conn.in_len] = '\0';
+
+		irc_last_recv_ms = util_mono_ms();
+		ping_sent = false;
+
+		char* line = irc_conn.in;
+		char* end;
+
+		while((end = memchr(line, '\n', irc_conn.in + irc_conn.in_len - line))){
+			*end = '\0';
+			if(end > line && end[-1] == '\r') end[-1] = '\0';
+
+			IRCMsg msg;
+			if(util_irc_parse(line, &msg)){
+				util_irc_dispatch(&msg);
+			}
+
+			// a callback might have caused a disconnect, which resets the buffer
+			if(irc_conn.state == IRC_STATE_DISCONNECTED) return;
+
+			line = end + 1;
+		}
+
+		irc_conn.in_len -= (line - irc_conn.in);
+		memmove(irc_conn.in, line, irc_conn.in_len);
+	}
+}
+
+static void util_irc_register(void){
+	irc_conn.state = IRC_STATE_REGISTERING;
+
+	if(pass){
+		util_irc_send("PASS %s", pass);
+	}
+	util_irc_send("NICK %s", user);
+	util_irc_send("USER %s 0 * :%s", user, user);
+}
+
+static void util_irc_handshake(void){
+	irc_conn.ssl_want_write = false;
+
+	int ret = SSL_connect(irc_conn.ssl);
+	if(ret == 1){
+		util_irc_register();
+	} else if(!util_irc_ssl_retry(ret, "SSL_connect")){
+		util_irc_disconnect();
+	}
+}
+
+static void util_irc_fd_cb(int fd, int events, void* arg){
+
+	if(irc_conn.state == IRC_STATE_CONNECTING){
+		int err = 0;
+		socklen_t err_len = sizeof(err);
+		getsockopt(fd, SOL_SOCKET, SO_ERROR, &err, &err_len);
+
+		if(err){
+			fprintf(stderr, "Unable to connect: %s\n", strerror(err));
+			util_irc_disconnect();
+			return;
+		}
+
+		if(irc_conn.ssl){
+			irc_conn.state = IRC_STATE_HANDSHAKE;
+		} else {
+			util_irc_register();
+		}
+	}
+
+	if(irc_conn.state == IRC_STATE_HANDSHAKE){
+		util_irc_handshake();
+	}
+
+	if(irc_conn.state >= IRC_STATE_REGISTERING){
+		if(events & (IRC_FD_READ | IRC_FD_ERROR)){
+			util_irc_read();
+		}
+		if(events & IRC_FD_WRITE){
+			util_irc_flush();
+		}
+	}
+
+	util_irc_fd_update();
+}
+
+static void util_irc_fd_update(void){
+	if(irc_conn.fd == -1) return;
+
+	int events = IRC_FD_READ;
+
+	if(
+		irc_conn.state == IRC_STATE_CONNECTING ||
+		irc_conn.ssl_want_write ||
+		irc_conn.out_off < sb_count(irc_conn.out)
+	){
+		events |= IRC_FD_WRITE;
+	}
+
+	IRCFdWatch* w = util_fd_find(irc_conn.fd);
+	if(!w || w->events != events){
+		util_fd_watch(irc_conn.fd, events, NULL, &util_irc_fd_cb, NULL);
+	}
+}
+
+// starts a non-blocking connection to the server, registration happens in util_irc_fd_cb once it completes.
+static bool util_irc_connect(const char* host, const char* port, bool use_ssl){
+	struct addrinfo hints = {
+		.ai_family   = AF_UNSPEC,
+		.ai_socktype = SOCK_STREAM,
+	};
+	struct addrinfo* addrs = NULL;
+
+	int ret = getaddrinfo(host, port, &hints, &addrs);
+	if(ret != 0){
+		fprintf(stderr, "Unable to resolve %s: %s\n", host, gai_strerror(ret));
+		return false;
+	}
+
+	for(struct addrinfo* a = addrs; a; a = a->ai_next){
+		int fd = socket(a->ai_family, a->ai_socktype | SOCK_NONBLOCK | SOCK_CLOEXEC, a->ai_protocol);
+		if(fd == -1) continue;
+
+		if(connect(fd, a->ai_addr, a->ai_addrlen) == 0 || errno == EINPROGRESS){
+			irc_conn.fd = fd;
+			break;
+		}
+
+		close(fd);
+	}
+
+	freeaddrinfo(addrs);
+
+	if(irc_conn.fd == -1){
+		fprintf(stderr, "Unable to connect: %s\n", strerror(errno));
+		return false;
+	}
+
+	int one = 1;
+	setsockopt(irc_conn.fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+
+	if(use_ssl){
+		if(!irc_conn.ssl_ctx){
+			irc_conn.ssl_ctx = SSL_CTX_new(TLS_client_method());
+			//XXX: you might not want this!
+			SSL_CTX_set_verify(irc_conn.ssl_ctx, SSL_VERIFY_NONE, NULL);
+		}
+
+		irc_conn.ssl = SSL_new(irc_conn.ssl_ctx);
+		SSL_set_fd(irc_conn.ssl, irc_conn.fd);
+		SSL_set_tlsext_host_name(irc_conn.ssl, host);
+		SSL_set_mode(irc_conn.ssl, SSL_MODE_ENABLE_PARTIAL_WRITE | SSL_MODE_ACCEPT_MOVING_WRITE_BUFFER);
+	}
+
+	irc_conn.state = IRC_STATE_CONNECTING;
+	util_irc_fd_update();
+
+	irc_last_recv_ms = util_mono_ms();
+	ping_sent = false;
+
+	return true;
+}
+
+// mIRC formatting codes: bold, color, hex color, reset, monospace, reverse, italic, strikethrough, underline
+static void util_strip_colors(char* msg){
+	char* w = msg;
+
+	for(const char* r = msg; *r; ++r){
+		switch(*r){
+			case '\x02': case '\x0F': case '\x11': case '\x16': case '\x1D': case '\x1E': case '\x1F':
+				break;
+
+			case '\x03': {
+				if(isdigit(r[1])) ++r;
+				if(isdigit(r[1])) ++r;
+				if(r[1] == ',' && isdigit(r[2])){
+					r += 2;
+					if(isdigit(r[1])) ++r;
+				}
+			} break;
+
+			case '\x04': {
+				for(int i = 0; i < 6 && isxdigit(r[1]); ++i) ++r;
+				if(r[1] == ',' && isxdigit(r[2])){
+					++r;
+					for(int i = 0; i < 6 && isxdigit(r[1]); ++i) ++r;
+				}
+			} break;
+
+			default: {
+				*w++ = *r;
+			} break;
+		}
+	}
+
+	*w = '\0';
+}
+
+/*****************
+ * IRC Callbacks *
+ *****************/
+
+IRC_STR_CALLBACK(on_connect) {
+	printf("Our nick is %s\n", params[0]);
+	free(bot_nick);
+	bot_nick = strdup(params[0]);
+
+	IRC_MOD_CALL_ALL(on_connect, (serv));
+}
+
+IRC_STR_CALLBACK(on_chat_msg) {
+	if(count < 2 || !params[0] || !params[1]) return;
+
+	const char *_chan = params[0], *_name = origin;
+
+	// null-prefix the msg, so that cmds can walk backwards to see the full msg
+	char* _msg = (char*)params[1];
+	_msg[-1] = 0;
+
+	util_trim_end_spaces(_msg, strlen(_msg));
+
+	send_msg_called = false;
+	handling_msg = true;
+
+	const size_t word_len = strcspn(_msg, " ");
+	const CmdIndexEntry* cmd_entry = util_cmd_index_find(_msg, word_len);
+	const CmdHandler* handlers = cmd_entry ? cmd_entry->handlers : NULL;
+	const CmdHandler* handlers_end = cmd_entry ? sb_end(cmd_entry->handlers) : NULL;
+
+	for(Module* m = irc_modules; m < sb_end(irc_modules); ++m){
+		if(m->init_state != MOD_INIT_READY) continue;
+
+		bool global = m->ctx->flags & IRC_MOD_GLOBAL;
+
+		const CmdHandler* mod_handlers = handlers;
+		while(handlers < handlers_end && handlers->mod == m - irc_modules) ++handlers;
+
+		if(mod_handlers != handlers && (global || util_check_perms(m, _chan, IRC_CB_CMD))){
+			util_dispatch_cmds(m, mod_handlers, handlers, _chan, _name, _msg + word_len);
+		}
+		if(m->ctx->on_msg && (global || util_check_perms(m, _chan, IRC_CB_MSG))){
+			IRC_MOD_CALL(m, on_msg, (_chan, _name, _msg));
+		}
+	}
+
+	handling_msg = false;
+}
+
+IRC_STR_CALLBACK(on_action) {
+	if(count < 2 || !params[0] || !params[1]) return;
+
+	const char *_chan = params[0], *_name = origin;
+	char* _msg = (char*)params[1];
+	util_trim_end_spaces(_msg, strlen(_msg));
+
+	handling_msg = true;
+	IRC_MOD_CALL_ALL_CHECK(on_action, (_chan, _name, _msg), IRC_CB_ACTION);
+	handling_msg = false;
+}
+
+IRC_STR_CALLBACK(on_pm){
+	if(count < 2 || !params[1] || !origin) return;
+
+	const char* _name = origin;
+	char* _msg = (char*)params[1];
+	util_trim_end_spaces(_msg, strlen(_msg));
+
+	handling_msg = true;
+	IRC_MOD_CALL_ALL(on_pm, (_name, _msg));
+	handling_msg = false;
+}
+
+IRC_STR_CALLBACK(on_join) {
+	if(count < 1 || !origin || !params[0]) return;
+	util_log(IRC_LOG_INFO, "JOIN: %s %s\n", params[0], origin);
+
+	util_member_add(util_chan_add(params[0]), origin);
+
+	// if we're joining the debug channel, set the global so we know we can now send stuff
+	const char* c = getenv("INSOBOT_DEBUG_CHAN");
+	if(c && strcmp(origin, bot_nick) == 0 && strcmp(params[0], c) == 0){
+		debug_chan = c;
+		if(debug_pipe[0]){
+			util_fd_watch(debug_pipe[0], IRC_FD_READ, NULL, &util_debug_pipe_cb, NULL);
+		}
+	}
+
+	//XXX: can't use CHECK here unless our own name bypasses it FIXME
+	IRC_MOD_CALL_ALL(on_join, (params[0], origin));
+}
+
+IRC_STR_CALLBACK(on_part) {
+	if(count < 1 || !origin || !params[0]) return;
+
+	IRCChan* chan = util_chan_find(params[0]);
+	IRCNick* nick = util_nick_find(origin);
+
+	util_log(IRC_LOG_INFO, "PART: %s %s\n", params[0], origin);
+
+	if(chan && strcasecmp(origin, bot_nick) == 0){
+		util_chan_remove(chan);
+	} else if(chan && nick){
+		util_member_remove(chan, nick);
+	}
+
+	IRC_MOD_CALL_ALL_CHECK(on_part, (params[0], origin), IRC_CB_PART);
+}
+
+IRC_STR_CALLBACK(on_quit) {
+	if(!origin) return;
+
+	util_log(IRC_LOG_INFO, "QUIT: %s\n", origin);
+
+	IRCNick* nick = util_nick_find(origin);
+	if(!nick) return;
+
+	// copy the channel names, since modules could part them while handling on_part
+	size_t num_chans = sb_count(nick->chans);
+	char** chans = alloca(num_chans * sizeof(char*));
+
+	for(size_t i = 0; i < num_chans; ++i){
+		chans[i] = strdupa(sb_last(nick->chans).chan->key.name);
+		util_member_remove(sb_last(nick->chans).chan, nick);
+	}
+
+	for(size_t i = 0; i < num_chans; ++i){
+		IRC_MOD_CALL_ALL_CHECK(on_part, (chans[i], origin), IRC_CB_PART);
+	}
+}
+
+IRC_STR_CALLBACK(on_nick) {
+	if(count < 1 || !origin || !params[0]) return;
+
+	if(strcmp(origin, bot_nick) == 0){
+		printf("We changed nicks! new nick: %s\n", params[0]);
+		free(bot_nick);
+		bot_nick = strdup(params[0]);
+	}
+
+	IRCNick* nick = util_nick_find(origin);
+	if(nick){
+		util_nick_rename(nick, params[0]);
+	}
+
+	IRC_MOD_CALL_ALL(on_nick, (origin, params[0]));
+}
+
+IRC_STR_CALLBACK(on_unknown) {
+	if(strcmp(event, "PONG") == 0){
+//		printf(":: PONG");
+		return;
+	}
+
+	if(unknown_log){
+		int64_t now = util_mono_ms();
+
+		if(now - unknown_log_window >= 60000){
+			if(unknown_log_skipped){
+				util_log(IRC_LOG_INFO, "(%u unknown events not logged)\n", unknown_log_skipped);
+			}
+			unknown_log_window  = now;
+			unknown_log_count   = 0;
+			unknown_log_skipped = 0;
+		}
+
+		if(unknown_log_count < UNKNOWN_LOG_MAX){
+			++unknown_log_count;
+
+			char buf[1024];
+			char* p = buf;
+			size_t sz = sizeof(buf);
+
+			snprintf_chain(&p, &sz, "Unknown event:\n:: %s :: %s", event, origin);
+			for(size_t i = 0; i < count; ++i){
+				snprintf_chain(&p, &sz, " :: %s", params[i]);
+			}
+			util_log(IRC_LOG_INFO, "%s", buf);
+		} else {
+			++unknown_log_skipped;
+		}
+	}
+
+	IRC_MOD_CALL_ALL(on_unknown, (event, origin, params, count));
+}
+
+static int util_tag_int(const char* key, int def){
+	const char* val = core_get_tag_by_name(key);
+	return (val && *val) ? atoi(val) : def;
+}
+
+IRC_NUM_CALLBACK(on_twitch) {
+	IRCTwitchEvent ev = {
+		.type = event,
+		.chan = (event != IRC_TWITCH_WHISPER && count >= 1) ? params[0] : NULL,
+	};
+
+	switch(event){
+		case IRC_TWITCH_USERNOTICE: {
+			ev.name       = core_get_tag_by_name("login");
+			ev.msg_id     = core_get_tag_by_name("msg-id");
+			ev.system_msg = core_get_tag_by_name("system-msg");
+			if(count >= 2){
+				char* msg = (char*)params[1];
+				util_trim_end_spaces(msg, strlen(msg));
+				ev.msg = msg;
+			}
+		} break;
+
+		case IRC_TWITCH_ROOMSTATE: {
+			static const struct {
+				const char* tag;
+				int bit;
+			} room_tags[] = {
+				{ "slow"          , IRC_ROOM_SLOW       },
+				{ "followers-only", IRC_ROOM_FOLLOWERS  },
+				{ "subs-only"     , IRC_ROOM_SUBS_ONLY  },
+				{ "emote-only"    , IRC_ROOM_EMOTE_ONLY },
+				{ "r9k"           , IRC_ROOM_R9K        },
+			};
+
+			for(size_t i = 0; i < ARRAY_SIZE(room_tags); ++i){
+				if(core_get_tag_by_name(room_tags[i].tag)){
+					ev.room_changed |= room_tags[i].bit;
+				}
+			}
+
+			ev.slow       = util_tag_int("slow", 0);
+			ev.followers  = util_tag_int("followers-only", -1);
+			ev.subs_only  = util_tag_int("subs-only", 0);
+			ev.emote_only = util_tag_int("emote-only", 0);
+			ev.r9k        = util_tag_int("r9k", 0);
+		} break;
+
+		case IRC_TWITCH_USERSTATE: {
+			ev.name   = bot_nick;
+			ev.is_mod = util_tag_int("mod", 0);
+		} break;
+
+		case IRC_TWITCH_CLEARCHAT: {
+			ev.name     = count >= 2 ? params[1] : NULL;
+			ev.duration = util_tag_int("ban-duration", 0);
+		} break;
+
+		case IRC_TWITCH_WHISPER: {
+			if(!origin || count < 2) return;
+			char* msg = (char*)params[1];
+			util_trim_end_spaces(msg, strlen(msg));
+			ev.name = origin;
+			ev.msg  = msg;
+		} break;
+	}
+
+	if(!ev.chan && event != IRC_TWITCH_WHISPER) return;
+
+	handling_msg = true;
+	IRC_MOD_CALL_ALL(on_twitch, (&ev));
+	handling_msg = false;
+}
+
+IRC_NUM_CALLBACK(on_numeric) {
+	static const char nick_start_symbols[] = "[]\\`_^{|}";
+	
+	if(event == IRC_RPL_NAMREPLY && count >= 4 && params[2] && params[3]){
+		const char*  chan_name = params[2];
+		size_t       names_len = strlen(params[3]);
+		char*        names     = alloca(names_len + 1);
+		const char** nicks     = alloca((names_len / 2 + 1) * sizeof(char*));
+		size_t       num_nicks = 0;
+
+		memcpy(names, params[3], names_len + 1);
+
+		char *state = NULL, *n = strtok_r(names, " ", &state);
+		for(; n; n = strtok_r(NULL, " ", &state)){
+			if(!isalpha(*n) && !strchr(nick_start_symbols, *n)){
+				++n;
+			}
+			if(*n) nicks[num_nicks++] = n;
+		}
+
+		util_log(IRC_LOG_INFO, "NAMES: %s %zu\n", chan_name, num_nicks);
+
+		IRCChan* chan = util_chan_add(chan_name);
+		for(size_t i = 0; i < num_nicks; ++i){
+			util_member_add(chan, nicks[i]);
+		}
+
+		for(Module* m = irc_modules; m < sb_end(irc_modules); ++m){
+			if(m->init_state != MOD_INIT_READY) continue;
+			util_mod_names(m, chan_name, nicks, num_nicks);
+		}
+	} else {
+		char buf[1024];
+		char* p = buf;
+		size_t sz = sizeof(buf);
+
+		snprintf_chain(&p, &sz, ":: [%03u] :: %s", event, origin);
+		for(size_t i = 0; i < count; ++i){
+			snprintf_chain(&p, &sz, " :: %s", params[i]);
+		}
+		util_log(IRC_LOG_DEBUG, "%s", buf);
+	}
+}
+
+/********************
+ * IRCCoreCtx funcs *
+ ********************/
+
+static intptr_t core_get_info(int id){
+	switch(id){
+		case IRC_INFO_CAN_PARSE_TAGS: {
+			return true;
+		} break;
+
+		case IRC_INFO_CMD_QUEUE_DEPTH: {
+			return util_cmd_total();
+		} break;
+
+		case IRC_INFO_CMD_QUEUE_HIGH_WATER: {
+			return cmd_queue_high_water;
+		} break;
+
+		case IRC_INFO_CMD_QUEUE_DROPPED: {
+			intptr_t dropped = 0;
+			for(int lane = 0; lane < CMD_LANE_COUNT; ++lane){
+				dropped += cmd_queue[lane].dropped;
+			}
+			return dropped;
+		} break;
+
+		default: {
+			return 0;
+		} break;
+	}
+}
+
+static const char* core_get_username(void){
+	return bot_nick;
+}
+
+//FIXME: would it be better to return a malloc'd string instead?
+static char datafile_buff[PATH_MAX];
+
+static const char* core_get_datafile(void){
+	Module* caller = sb_last(mod_call_stack);
+
+	strncpy(datafile_buff, caller->lib_path, sizeof(datafile_buff) - 1);
+	datafile_buff[sizeof(datafile_buff) - 1] = 0;
+
+	char* end_ptr = strrchr(datafile_buff, '/');
+	if(!end_ptr){
+		end_ptr = datafile_buff + 1;
+		*datafile_buff = '.';
+	}
+
+	const size_t sz = sizeof(datafile_buff) - (end_ptr - datafile_buff);
+	snprintf(end_ptr, sz - 1, "/data/%s.data", caller->ctx->name);
+
+	if(access(datafile_buff, F_OK) != 0){
+		inotify.data.wd = inotify_add_watch(inotify.fd, inotify.data.path, IN_DELETE_SELF);
+		close(creat(datafile_buff, 00600));
+		inotify.data.wd = inotify_add_watch(inotify.fd, inotify.data.path, IN_CLOSE_WRITE | IN_MOVED_TO);
+	}
+
+	return datafile_buff;
+}
+
+static IRCModuleCtx** core_get_modules(bool chan_only){
+
+	if(mod_list_dirty){
+		while(sb_count(chan_mod_list) > 0) sb_pop(chan_mod_list);
+		while(sb_count(global_mod_list) > 0) sb_pop(global_mod_list);
+
+		for(Module* m = irc_modules; m < sb_end(irc_modules); ++m){
+			if(m->init_state != MOD_INIT_READY) continue;
+			sb_push(global_mod_list, m->ctx);
+			if(!(m->ctx->flags & IRC_MOD_GLOBAL)){
+				sb_push(chan_mod_list, m->ctx);
+			}
+		}
+
+		sb_push(chan_mod_list, 0);
+		sb_push(global_mod_list, 0);
+
+		mod_list_dirty = false;
+	}
+
+	return chan_only ? chan_mod_list : global_mod_list;
+}
+
+static const char** core_get_channels(void){
+	return (const char**)channels;
+}
+
+static const char** core_get_nicks(const char* chan, int* count){
+	assert(count);
+
+	IRCChan* c = util_chan_find(chan);
+
+	if(c){
+		*count = sb_count(c->nicks);
+		return (const char**)c->nicks;
+	} else {
+		*count = 0;
+		return NULL;
+	}
+}
+
+static void core_join(const char* chan){
+
+	util_cmd_enqueue(IRC_CMD_JOIN, chan, NULL); //TODO: password protected channels?
+
+	if(!util_chan_find(chan)){
+		util_member_add(util_chan_add(chan), bot_nick);
+	}
+}
+
+static void core_part(const char* chan){
+	
+	util_cmd_enqueue(IRC_CMD_PART, chan, NULL);
+
+	IRCChan* c = util_chan_find(chan);
+	if(c){
+		util_chan_remove(c);
+	}
+}
+
+static size_t core_send_msg(const char* chan, const char* fmt, ...){
+	if(!chan || !fmt) return 0;
+
+	size_t id = 0;
+	char* buff = NULL;
+	va_list v;
+
+	va_start(v, fmt);
+	int len = vasprintf(&buff, fmt, v);
+	va_end(v);
+
+	if(len > 0){
+		id = util_msg_enqueue(chan, buff, len);
+	}
+
+	free(buff);
+
+	send_msg_called = true;
+
+	return id;
+}
+
+static size_t core_send_raw(const char* raw){
+	return util_cmd_enqueue(IRC_CMD_RAW, NULL, raw);
+}
+
+static void core_send_ipc(int target, const void* data, size_t data_len){
+	if(!ipc_ring) return;
+
+	Module* m = sb_count(mod_call_stack) ? sb_last(mod_call_stack) : NULL;
+	const char* name = m ? m->ctx->name : "core";
+
+	util_log(IRC_LOG_DEBUG, "Sending IPC msg to %d for %s\n", target, name);
+
+	util_ipc_write(m ? m->ipc_id : util_ipc_mod_id(name), target, data, data_len);
+}
+
+static void core_send_mod_msg(IRCModMsg* msg){
+	const char* sender = sb_last(mod_call_stack)->ctx->name;
+	IRC_MOD_CALL_ALL(on_mod_msg, (sender, msg));
+}
+
+static void core_self_save(void){
+	Module* m = sb_last(mod_call_stack);
+
+	if(!bg_save){
+		util_module_save(m);
+		return;
+	}
+
+	m->save_pending = true;
+	if(!m->snapshot && !m->save_timer){
+		m->save_timer = util_timer_add(0, 0, m->ctx, &util_module_bgsave_cb, NULL);
+	}
+}
+
+static void core_log(const char* fmt, ...){
+	va_list v;
+	va_start(v, fmt);
+	util_log_as_caller(IRC_LOG_INFO, fmt, v);
+	va_end(v);
+}
+
+static void core_log_at(int level, const char* fmt, ...){
+	level = INSO_MIN(INSO_MAX(level, IRC_LOG_DEBUG), IRC_LOG_ERROR);
+
+	va_list v;
+	va_start(v, fmt);
+	util_log_as_caller(level, fmt, v);
+	va_end(v);
+}
+
+static bool core_set_log_level(const char* mod_name, int level){
+	level = INSO_MIN(INSO_MAX(level, IRC_LOG_DEBUG), IRC_LOG_ERROR);
+
+	if(!mod_name){
+		log_level_core = level;
+		return true;
+	}
+
+	Module* m = util_module_get(mod_name, MOD_GET_CTXNAME);
+	if(!m) return false;
+
+	m->log_level = level;
+	return true;
+}
+
+static void core_strip_colors(char* msg){
+	util_strip_colors(msg);
+}
+
+static bool core_responded(void){
+	return send_msg_called;
+}
+
+static bool core_get_tag(size_t index, const char** k, const char** v){
+	if(!irc_tags_parsed) util_parse_tags();
+
+	index <<= 1;
+
+	if(index >= sb_count(irc_tag_ptrs)){
+		return false;
+	}
+
+	if(k) *k = irc_tag_ptrs[index+0];
+	if(v) *v = irc_tag_ptrs[index+1];
+
+	return true;
+}
+
+static const char* core_get_tag_by_name(const char* key){
+	if(!irc_tags_parsed) util_parse_tags();
+
+	const size_t index_size = sb_count(irc_tag_index);
+	if(!key || !index_size) return NULL;
+
+	for(size_t slot = util_tag_hash(key) & (index_size - 1); irc_tag_index[slot]; slot = (slot + 1) & (index_size - 1)){
+		const size_t i = (irc_tag_index[slot] - 1) * 2;
+		if(strcmp(irc_tag_ptrs[i], key) == 0){
+			return irc_tag_ptrs[i+1];
+		}
+	}
+
+	return NULL;
+}
+
+static void core_gen_event(int which, ...){
+	const char *chan = NULL, *origin = NULL, *msg = NULL;
+
+	va_list va;
+	va_start(va, which);
+
+	switch(which){
+		case IRC_CB_MSG:
+		case IRC_CB_ACTION: {
+			chan   = va_arg(va, const char*);
+			origin = va_arg(va, const char*);
+			msg    = va_arg(va, const char*);
+		} break;
+
+		case IRC_CB_JOIN:
+		case IRC_CB_PART: {
+			chan   = va_arg(va, const char*);
+			origin = va_arg(va, const char*);
+		} break;
 
-static intptr_t core_get_info(int id){
-	switch(id){
-		case IRC_INFO_CAN_PARSE_TAGS: {
-			return have_tag_hack;
+		case IRC_CB_NICK: {
+			origin = va_arg(va, const char*); // prev_nick
+			msg    = va_arg(va, const char*); // new_nick
 		} break;
 
-		default: {
-			return 0;
+		case IRC_CB_PM: {
+			origin = va_arg(va, const char*);
+			msg    = va_arg(va, const char*);
 		} break;
+
+		default: {
+			va_end(va);
+			return;
+		}
 	}
+
+	va_end(va);
+
+	util_event_push(which, chan, origin, msg);
 }
 
-static const char* core_get_username(void){
-	return bot_nick;
+static void core_watch_fd(int fd, int events, IRCFdCallback cb, void* arg){
+	IRCModuleCtx* owner = sb_count(mod_call_stack) ? sb_last(mod_call_stack)->ctx : NULL;
+	util_fd_watch(fd, events, owner, cb, arg);
 }
 
-//FIXME: would it be better to return a malloc'd string instead?
-static char datafile_buff[PATH_MAX];
+static bool core_http_request(const char* url, const IRCHTTPOpts* opts, void (*cb)(const IRCHTTPResult*, void*), void* arg){
+	const IRCHTTPOpts default_opts = {};
+	if(!opts) opts = &default_opts;
 
-static const char* core_get_datafile(void){
-	Module* caller = sb_last(mod_call_stack);
+	// opts->curl is owned by the core even if the request can't be made
+	if(!curl_multi || !cb || (!url && !opts->curl) || mod_cancelling){
+		if(opts->curl) curl_easy_cleanup(opts->curl);
+		return false;
+	}
 
-	strncpy(datafile_buff, caller->lib_path, sizeof(datafile_buff) - 1);
-	datafile_buff[sizeof(datafile_buff) - 1] = 0;
+	IRCHTTPReq* req = calloc(1, sizeof(*req));
+	req->owner = sb_count(mod_call_stack) ? sb_last(mod_call_stack)->ctx : NULL;
+	req->cb    = cb;
+	req->arg   = arg;
 
-	char* end_ptr = strrchr(datafile_buff, '/');
-	if(!end_ptr){
-		end_ptr = datafile_buff + 1;
-		*datafile_buff = '.';
+	if(opts->curl){
+		req->curl = opts->curl;
+	} else {
+		// same defaults as inso_curl_reset
+		req->curl = curl_easy_init();
+		curl_easy_setopt(req->curl, CURLOPT_FAILONERROR, 1);
+		curl_easy_setopt(req->curl, CURLOPT_ACCEPT_ENCODING, "");
+		curl_easy_setopt(req->curl, CURLOPT_USERAGENT, "insobot");
+		curl_easy_setopt(req->curl, CURLOPT_TCP_NODELAY, 1);
+		curl_easy_setopt(req->curl, CURLOPT_TIMEOUT, 8);
 	}
 
-	const size_t sz = sizeof(datafile_buff) - (end_ptr - datafile_buff);
-	snprintf(end_ptr, sz - 1, "/data/%s.data", caller->ctx->name);
-
-	if(access(datafile_buff, F_OK) != 0){
-		inotify.data.wd = inotify_add_watch(inotify.fd, inotify.data.path, IN_DELETE_SELF);
-		close(creat(datafile_buff, 00600));
-		inotify.data.wd = inotify_add_watch(inotify.fd, inotify.data.path, IN_CLOSE_WRITE | IN_MOVED_TO);
+	if(url){
+		curl_easy_setopt(req->curl, CURLOPT_URL, url);
 	}
 
-	return datafile_buff;
-}
+	if(opts->timeout){
+		curl_easy_setopt(req->curl, CURLOPT_TIMEOUT, opts->timeout);
+	}
 
-static IRCModuleCtx** core_get_modules(bool chan_only){
+	if(opts->headers){
+		for(const char** h = opts->headers; *h; ++h){
+			req->headers = curl_slist_append(req->headers, *h);
+		}
+		curl_easy_setopt(req->curl, CURLOPT_HTTPHEADER, req->headers);
+	}
 
-	if(mod_list_dirty){
-		while(sb_count(chan_mod_list) > 0) sb_pop(chan_mod_list);
-		while(sb_count(global_mod_list) > 0) sb_pop(global_mod_list);
+	if(opts->post_data){
+		curl_easy_setopt(req->curl, CURLOPT_COPYPOSTFIELDS, opts->post_data);
+	}
 
-		for(Module* m = irc_modules; m < sb_end(irc_modules); ++m){
-			sb_push(global_mod_list, m->ctx);
-			if(!(m->ctx->flags & IRC_MOD_GLOBAL)){
-				sb_push(chan_mod_list, m->ctx);
-			}
-		}
+	curl_easy_setopt(req->curl, CURLOPT_NOSIGNAL, 1);
+	curl_easy_setopt(req->curl, CURLOPT_WRITEFUNCTION, &util_http_write_cb);
+	curl_easy_setopt(req->curl, CURLOPT_WRITEDATA, req);
+	curl_easy_setopt(req->curl, CURLOPT_PRIVATE, req);
 
-		sb_push(chan_mod_list, 0);
-		sb_push(global_mod_list, 0);
+	sb_push(http_reqs, req);
 
-		mod_list_dirty = false;
+	if(curl_multi_add_handle(curl_multi, req->curl) != CURLM_OK){
+		req->cb = NULL;
+		util_http_free(req);
+		return false;
 	}
 
-	return chan_only ? chan_mod_list : global_mod_list;
+	return true;
 }
 
-static const char** core_get_channels(void){
-	return (const char**)channels;
+static void core_perms_changed(const char* chan){
+	util_perm_cache_clear(chan);
 }
 
-static const char** core_get_nicks(const char* chan, int* count){
-	assert(count);
+static InternName* util_intern(const char* str){
+	InternName* n = (InternName*)util_names_find(&intern_table, str);
+	if(n) return n;
 
-	int index = -1;
-	for(size_t i = 0; i < sb_count(channels) - 1; ++i){
-		if(strcasecmp(channels[i], chan) == 0){
-			index = i;
-			break;
-		}
+	n = calloc(1, sizeof(*n));
+	n->key.name = strdup(str);
+	for(char* p = n->key.name; *p; ++p){
+		*p = util_irc_tolower(*p);
 	}
+	util_names_insert(&intern_table, &n->key);
 
-	if(index >= 0){
-		*count = sb_count(chan_nicks[index]);
-		return (const char**)chan_nicks[index];
-	} else {
-		*count = 0;
-		return NULL;
-	}
+	return n;
 }
 
-static void core_join(const char* chan){
+static const char* core_intern(const char* str){
+	if(!str) return NULL;
 
-	util_cmd_enqueue(IRC_CMD_JOIN, chan, NULL); //TODO: password protected channels?
+	InternName* n = util_intern(str);
+	n->pinned = true;
 
-	int chan_i, nick_i;
-	util_find_chan_nick(chan, bot_nick, &chan_i, &nick_i);
+	return n->key.name;
+}
 
-	if(chan_i == -1){
-		sb_last(channels) = strdup(chan);
-		chan_i = sb_count(channels) - 1;
-		
-		sb_push(channels, 0);
+static const char* core_intern_ref(const char* str){
+	if(!str) return NULL;
 
-		sb_push(chan_nicks, 0);
-		sb_push(chan_nicks[chan_i], strdup(bot_nick));
-	}
+	InternName* n = util_intern(str);
+	++n->refs;
 
+	return n->key.name;
 }
 
-static void core_part(const char* chan){
-	
-	util_cmd_enqueue(IRC_CMD_PART, chan, NULL);
+static void core_intern_release(const char* str){
+	if(!str) return;
 
-	for(char** c = channels; *c; ++c){
-		if(strcmp(*c, chan) == 0){
-			free(*c);
-			sb_erase(channels, c - channels);
-			break;
-		}
+	// only pointers that intern_ref gave out are accepted
+	InternName* n = (InternName*)util_names_find(&intern_table, str);
+	if(!n || n->key.name != str || !n->refs) return;
+
+	if(--n->refs == 0 && !n->pinned){
+		util_names_remove(&intern_table, &n->key);
+		free(n->key.name);
+		free(n);
 	}
 }
 
-static size_t core_send_msg(const char* chan, const char* fmt, ...){
-	if(!chan || !fmt) return 0;
+static int core_add_timer(int delay_ms, int repeat_ms, IRCTimerCallback cb, void* arg){
+	IRCModuleCtx* owner = sb_count(mod_call_stack) ? sb_last(mod_call_stack)->ctx : NULL;
+	return util_timer_add(delay_ms, repeat_ms, owner, cb, arg);
+}
 
-	size_t id = 0;
-	char buff[1024];
-	va_list v;
+static void core_cancel_timer(int id){
+	util_timer_cancel(id);
+}
 
-	va_start(v, fmt);
-	if(vsnprintf(buff, sizeof(buff), fmt, v) > 0){
-		id = util_cmd_enqueue(IRC_CMD_MSG, chan, buff);
+static void util_async_run(IRCModuleCtx* owner, void (*work)(void*), void (*done)(void*), void* arg, bool cancel_done){
+	// if the threads can't be started, fall back to running it synchronously
+	if(!util_async_init()){
+		work(arg);
+		if(done) done(arg);
+		return;
 	}
-	va_end(v);
 
-	send_msg_called = true;
+	IRCAsyncJob* job = malloc(sizeof(*job));
+	*job = (IRCAsyncJob){
+		.work  = work,
+		.done  = done,
+		.arg         = arg,
+		.owner       = owner,
+		.cancel_done = cancel_done,
+	};
 
-	return id;
+	pthread_mutex_lock(&async_mutex);
+	util_async_push(&async_pending, job);
+	pthread_cond_signal(&async_work_cond);
+	pthread_mutex_unlock(&async_mutex);
 }
 
-static size_t core_send_raw(const char* raw){
-	return util_cmd_enqueue(IRC_CMD_RAW, NULL, raw);
+static void core_run_async(void (*work)(void*), void (*done)(void*), void* arg){
+	// the module is being unloaded, so there's no point starting anything new
+	if(mod_cancelling){
+		if(done) done(arg);
+		return;
+	}
+
+	IRCModuleCtx* owner = sb_count(mod_call_stack) ? sb_last(mod_call_stack)->ctx : NULL;
+	util_async_run(owner, work, done, arg, true);
 }
 
-static void core_send_ipc(int target, const void* data, size_t data_len){
-	if(ipc_socket <= 0) return;
+static bool core_cancelled(void){
+	return mod_cancelling;
+}
 
-	Module* m = sb_count(mod_call_stack) ? sb_last(mod_call_stack) : NULL;
-	const char* name = m ? m->ctx->name : "core";
-	const size_t name_len = strlen(name);
-	const size_t total_len = data_len + name_len + 1;
+static void* core_warm_get(const char* name, size_t size, uint32_t version, bool* restored){
+	Module* m = sb_last(mod_call_stack);
+	*restored = false;
+
+	if(!warm || !size) return NULL;
 
-	// why doesn't AF_UNIX support MSG_MORE? :(
-	char* buffer = malloc(total_len);
-	memcpy(buffer, name, name_len + 1);
-	memcpy(buffer + name_len + 1, data, data_len);
+	char key[sizeof(warm->segments[0].name)];
+	if(snprintf(key, sizeof(key), "%s/%s", m->ctx->name, name) >= (int)sizeof(key)) return NULL;
 
-	for(IPCAddress* p = ipc_peers; p < sb_end(ipc_peers); ++p){
-		if(target != 0 && p->id != target) continue;
+	WarmSegment* seg = NULL;
+	for(uint32_t i = 0; i < warm->count; ++i){
+		if(strcmp(warm->segments[i].name, key) == 0){
+			seg = warm->segments + i;
+			break;
+		}
+	}
 
-		printf("Sending IPC msg to %d for %s\n", p->id, name);
+	const size_t capacity = (size + 63) & ~(size_t)63;
 
-		if(sendto(ipc_socket, buffer, total_len, 0, &p->addr, sizeof(p->addr)) == -1){
-			bool remove = false;
+	// the last segment can grow in place. Others get new space, and util_warm_compact reclaims the old space on restart.
+	if(seg && seg->capacity < size && seg->offset + seg->capacity == warm->used && seg->offset + capacity <= WARM_SIZE - sizeof(WarmRegion)){
+		seg->committed = 0;
+		seg->capacity  = capacity;
+		warm->used     = seg->offset + capacity;
+	}
 
-			if(errno == ECONNREFUSED){
-				unlink(p->addr.sun_path);
-				remove = true;
-			} else if(errno == ENOENT){
-				remove = true;
-			} else {
-				perror("send_ipc: sendto");
-			}
+	if(!seg || seg->capacity < size){
+		if(warm->used + capacity > WARM_SIZE - sizeof(WarmRegion)){
+			fprintf(stderr, "No space left for warm restart segment %s (%zu bytes).\n", key, size);
+			return NULL;
+		}
 
-			if(remove){
-				printf("removing [%s]\n", p->addr.sun_path);
-				sb_erase(ipc_peers, p - ipc_peers);
-				--p;
+		if(!seg){
+			if(warm->count == WARM_MAX_SEGMENTS){
+				fprintf(stderr, "Too many warm restart segments for %s.\n", key);
+				return NULL;
 			}
+			seg = warm->segments + warm->count;
+			memcpy(seg->name, key, sizeof(key));
+		}
+
+		seg->committed = 0;
+		seg->offset    = warm->used;
+		seg->capacity  = capacity;
+		warm->used    += capacity;
+
+		if(seg == warm->segments + warm->count){
+			++warm->count;
 		}
 	}
 
-	free(buffer);
+	uint8_t* data = warm->data + seg->offset;
+
+	if(seg->committed && seg->version == version && seg->size == size && util_fnv1a(data, size) == seg->checksum){
+		printf("Restored warm restart segment %s (%zu bytes).\n", key, size);
+		*restored = true;
+	} else {
+		seg->committed = 0;
+		seg->version   = version;
+		seg->size      = size;
+		memset(data, 0, size);
+	}
+
+	return data;
 }
 
-static void core_send_mod_msg(IRCModMsg* msg){
-	const char* sender = sb_last(mod_call_stack)->ctx->name;
-	IRC_MOD_CALL_ALL(on_mod_msg, (sender, msg));
+static void core_warm_commit(void* mem){
+	if(!warm) return;
+
+	for(uint32_t i = 0; i < warm->count; ++i){
+		WarmSegment* seg = warm->segments + i;
+		if(warm->data + seg->offset != (uint8_t*)mem) continue;
+
+		seg->checksum  = util_fnv1a(mem, seg->size);
+		seg->committed = 1;
+		return;
+	}
 }
 
-static void core_self_save(void){
-	util_module_save(sb_last(mod_call_stack));
+// the smallest value that at least q of the calls took as long as or less than, to within the bucket size
+static uint64_t util_stats_percentile(const ModHist* h, double q){
+	const uint64_t target = INSO_MAX((uint64_t)(q * h->count + 0.5), 1ULL);
+	uint64_t seen = 0;
+
+	for(size_t i = 0; i < STATS_BUCKETS; ++i){
+		if((seen += h->buckets[i]) >= target){
+			return INSO_MIN(util_stats_bucket_max(i), h->max_ns);
+		}
+	}
+
+	return h->max_ns;
 }
 
-static void core_log(const char* fmt, ...){
+static int util_call_stats_sort(const void* a, const void* b){
+	const IRCCallStats* x = a;
+	const IRCCallStats* y = b;
+	return (x->total_ns < y->total_ns) - (x->total_ns > y->total_ns);
+}
+
+static size_t core_get_call_stats(const char* mod_name, IRCCallStats* out, size_t max){
+	IRCCallStats* all = NULL;
+
+	for(Module* m = irc_modules; m < sb_end(irc_modules); ++m){
+		if(!m->stats || (mod_name && strcmp(mod_name, m->ctx->name) != 0)) continue;
+
+		for(size_t i = 0; i < MOD_STAT_COUNT; ++i){
+			const ModHist* h = m->stats[i];
+			if(!h || !h->count) continue;
+
+			IRCCallStats st = {
+				.module   = m->ctx->name,
+				.callback = mod_stat_names[i],
+				.count    = h->count,
+				.total_ns = h->total_ns,
+				.p50_ns   = util_stats_percentile(h, 0.5),
+				.p90_ns   = util_stats_percentile(h, 0.9),
+				.p99_ns   = util_stats_percentile(h, 0.99),
+				.max_ns   = h->max_ns,
+			};
+			sb_push(all, st);
+		}
+	}
 
-	if(getenv("INSOBOT_NO_FORK")){
-		char time_buf[64];
-		time_t now = time(0);
-		struct tm* now_tm = localtime(&now);
-		strftime(time_buf, sizeof(time_buf), "[%F][%T]", now_tm);
+	const size_t count = sb_count(all);
+	qsort(all, count, sizeof(*all), &util_call_stats_sort);
 
-		const char* mod_name = sb_count(mod_call_stack) ? sb_last(mod_call_stack)->ctx->name : "CORE";
-		fprintf(stderr, "%s %s: ", time_buf, mod_name);
+	if(out){
+		memcpy(out, all, INSO_MIN(count, max) * sizeof(*all));
 	}
 
-	va_list v;
-	va_start(v, fmt);
-	vfprintf(stderr, fmt, v);
-	va_end(v);
+	sb_free(all);
+	return count;
 }
 
-static void core_strip_colors(char* msg){
-	char* stripped = irc_color_strip_from_mirc(msg);
-	assert(strlen(stripped) <= strlen(msg));
+static void core_init_later(void){
+	Module* m = sb_last(mod_call_stack);
 
-	memcpy(msg, stripped, strlen(stripped) + 1);
-	free(stripped);
+	// only makes sense from a (non-threaded) on_init
+	if(!mod_reloading || m->init_state != MOD_INIT_READY) return;
+
+	m->init_state    = MOD_INIT_PENDING;
+	m->timeline.mode = "later";
 }
 
-static bool core_responded(void){
-	return send_msg_called;
+static void core_init_done(bool ok){
+	util_module_init_finish(sb_last(mod_call_stack), ok);
 }
 
-static bool core_get_tag(size_t index, const char** k, const char** v){
-	index <<= 1;
+static bool core_journal_append(const void* data, size_t len){
+	Module* m = sb_last(mod_call_stack);
 
-	if(index >= sb_count(irc_tag_ptrs)){
+	if(len > JOURNAL_RECORD_MAX) return false;
+	if(m->journal.fd == -1 && !util_journal_open(m)) return false;
+
+	JournalRecord rec = {
+		.len  = len,
+		.hash = util_fnv1a(data, len),
+	};
+
+	struct iovec iov[] = {
+		{ &rec, sizeof(rec) },
+		{ (void*)data, len },
+	};
+
+	ssize_t n = writev(m->journal.fd, iov, ARRAY_SIZE(iov));
+	if(n != (ssize_t)(sizeof(rec) + len)){
+		fprintf(stderr, "Error appending to journal for %s: %s\n", m->ctx->name, n == -1 ? strerror(errno) : "short write");
+		// don't leave a partial record that later ones would be appended after
+		if(n > 0 && ftruncate(m->journal.fd, m->journal.size) == -1){
+			util_journal_close(m);
+		}
 		return false;
 	}
 
-	if(k) *k = irc_tag_ptrs[index+0];
-	if(v) *v = irc_tag_ptrs[index+1];
+	m->journal.size += n;
+
+	if(m->journal.size > m->journal.compact_at && !m->snapshot && !m->journal.compact_timer && m->ctx->on_save){
+		m->journal.compact_timer = util_timer_add(0, 0, m->ctx, &util_journal_compact_cb, NULL);
+	}
 
 	return true;
 }
 
-static void core_gen_event(int which, ...){
-	va_list va;
-	va_start(va, which);
-
-	// TODO: get tags in here?
-	const char* pbuf[3] = { "" };
-	const char** params = pbuf + 1;
-	const char* origin;
+static void core_journal_replay(void (*cb)(const void* data, size_t len, void* arg), void* arg){
+	Module* m = sb_last(mod_call_stack);
 
-	// TODO: queue this up in events like cmd_queue, and process later
-
-	switch(which){
-		case IRC_CB_MSG: {
-			params[0] = va_arg(va, const char*); // chan
-			origin    = va_arg(va, const char*); // name
-			params[1] = va_arg(va, const char*); // msg
+	struct stat st;
+	uint64_t data_ino = stat(core_get_datafile(), &st) == 0 ? st.st_ino : 0;
 
-			irc_on_chat_msg(irc_ctx, "", origin, params, 2);
-		} break;
+	uint32_t* gens = util_journal_gens();
+	bool replaying = false;
+	char* buf = NULL;
+	size_t buf_size = 0;
 
-		case IRC_CB_JOIN: {
-			params[0] = va_arg(va, const char*); // chan;
-			origin    = va_arg(va, const char*); // name;
+	for(uint32_t* g = gens; g < sb_end(gens); ++g){
+		const char* path = util_journal_path(*g);
+		m->journal.gen = INSO_MAX(m->journal.gen, *g);
 
-			irc_on_join(irc_ctx, "", origin, params, 1);
-		} break;
+		int fd = open(path, O_RDONLY | O_CLOEXEC);
+		if(fd == -1) continue;
 
-		case IRC_CB_PART: {
-			params[0] = va_arg(va, const char*); // chan;
-			origin    = va_arg(va, const char*); // name;
+		JournalHeader hdr;
+		bool valid = read(fd, &hdr, sizeof(hdr)) == sizeof(hdr) && hdr.magic == JOURNAL_MAGIC;
 
-			irc_on_part(irc_ctx, "", origin, params, 1);
-		} break;
+		// start from the first journal written on top of the current data file, earlier ones are already in it.
+		if(valid && !replaying && hdr.base_ino == data_ino){
+			replaying = true;
+		}
 
-		case IRC_CB_ACTION: {
-			params[0] = va_arg(va, const char*); // chan
-			origin    = va_arg(va, const char*); // name
-			params[1] = va_arg(va, const char*); // msg
+		if(!valid || !replaying){
+			close(fd);
+			unlink(path);
+			continue;
+		}
 
-			irc_on_action(irc_ctx, "", origin, params, 2);
-		} break;
+		JournalRecord rec;
+		size_t count = 0;
 
-		case IRC_CB_NICK: {
-			origin    = va_arg(va, const char*); // prev_nick
-			params[0] = va_arg(va, const char*); // new_nick
+		while(read(fd, &rec, sizeof(rec)) == sizeof(rec) && rec.len <= JOURNAL_RECORD_MAX){
+			if(rec.len >= buf_size){
+				buf_size = rec.len + 1;
+				buf = realloc(buf, buf_size);
+			}
 
-			irc_on_nick(irc_ctx, "", origin, params, 1);
-		} break;
+			if(read(fd, buf, rec.len) != rec.len || util_fnv1a(buf, rec.len) != rec.hash){
+				fprintf(stderr, "Journal %s has a torn record after %zu ok ones, ignoring the rest.\n", path, count);
+				break;
+			}
 
-		case IRC_CB_PM: {
-			// params[0] unused?
-			origin    = va_arg(va, const char*); // name
-			params[1] = va_arg(va, const char*); // msg
+			cb(buf, rec.len, arg);
+			++count;
+		}
 
-			irc_on_pm(irc_ctx, "", origin, params, 2);
-		} break;
+		close(fd);
 	}
 
-	va_end(va);
+	free(buf);
+	sb_free(gens);
 }
 
+
 /***************
  * entry point *
  * *************/
@@ -1375,6 +5589,12 @@ int main(int argc, char** argv){
 		util_multiprocess_init(); // NOTE: only the child process will return from this function
 	}
 
+	startup_ms = util_mono_ms();
+
+	util_log_init();
+
+	bg_save = getenv("INSOBOT_BG_SAVE");
+
 	srand(time(0));
 	signal(SIGSEGV, &util_handle_sig);
 	signal(SIGINT , &util_handle_sig);
@@ -1403,7 +5623,11 @@ int main(int argc, char** argv){
 		errx(1, "Path too long!");
 	}
 
-	// inotify init
+	// event loop & inotify init
+
+	if((epoll_fd = epoll_create1(EPOLL_CLOEXEC)) == -1){
+		err(errno, "epoll_create1");
+	}
 
 	inotify.fd = inotify_init1(IN_NONBLOCK);
 
@@ -1419,6 +5643,13 @@ int main(int argc, char** argv){
 
 	curl_global_init(CURL_GLOBAL_ALL);
 
+	if((curl_multi = curl_multi_init())){
+		curl_multi_setopt(curl_multi, CURLMOPT_SOCKETFUNCTION, &util_http_sock_cb);
+		curl_multi_setopt(curl_multi, CURLMOPT_TIMERFUNCTION, &util_http_timer_cb);
+	} else {
+		fputs("curl_multi_init failed, http_request won't work.\n", stderr);
+	}
+
 	// find modules
 
 	memcpy(path_end, glob_suffix, sizeof(glob_suffix));
@@ -1445,38 +5676,56 @@ int main(int argc, char** argv){
 	// modules init
 
 	static const IRCCoreCtx core_ctx = {
-		.api_version  = INSO_CORE_API_VERSION,
-		.get_info     = &core_get_info,
-		.get_username = &core_get_username,
-		.get_datafile = &core_get_datafile,
-		.get_modules  = &core_get_modules,
-		.get_channels = &core_get_channels,
-		.get_nicks    = &core_get_nicks,
-		.send_msg     = &core_send_msg,
-		.send_raw     = &core_send_raw,
-		.send_ipc     = &core_send_ipc,
-		.send_mod_msg = &core_send_mod_msg,
-		.join         = &core_join,
-		.part         = &core_part,
-		.save_me      = &core_self_save,
-		.log          = &core_log,
-		.strip_colors = &core_strip_colors,
-		.responded    = &core_responded,
-		.get_tag      = &core_get_tag,
-		.gen_event    = &core_gen_event,
+		.api_version     = INSO_CORE_API_VERSION,
+		.get_info        = &core_get_info,
+		.get_username    = &core_get_username,
+		.get_datafile    = &core_get_datafile,
+		.get_modules     = &core_get_modules,
+		.get_channels    = &core_get_channels,
+		.get_nicks       = &core_get_nicks,
+		.send_msg        = &core_send_msg,
+		.send_raw        = &core_send_raw,
+		.send_ipc        = &core_send_ipc,
+		.send_mod_msg    = &core_send_mod_msg,
+		.join            = &core_join,
+		.part            = &core_part,
+		.save_me         = &core_self_save,
+		.log             = &core_log,
+		.strip_colors    = &core_strip_colors,
+		.responded       = &core_responded,
+		.get_tag         = &core_get_tag,
+		.gen_event       = &core_gen_event,
+		.watch_fd        = &core_watch_fd,
+		.http_request    = &core_http_request,
+		.run_async       = &core_run_async,
+		.perms_changed   = &core_perms_changed,
+		.intern          = &core_intern,
+		.get_tag_by_name = &core_get_tag_by_name,
+		.add_timer       = &core_add_timer,
+		.cancel_timer    = &core_cancel_timer,
+		.log_at          = &core_log_at,
+		.set_log_level   = &core_set_log_level,
+		.journal_append  = &core_journal_append,
+		.journal_replay  = &core_journal_replay,
+		.warm_get        = &core_warm_get,
+		.warm_commit     = &core_warm_commit,
+		.init_later      = &core_init_later,
+		.init_done       = &core_init_done,
+		.get_call_stats  = &core_get_call_stats,
+		.intern_ref      = &core_intern_ref,
+		.intern_release  = &core_intern_release,
+		.cancelled       = &core_cancelled,
 	};
 
-	sb_push(channels, 0);
+	util_fd_watch(STDIN_FILENO, IRC_FD_READ, NULL, &util_stdin_cb, NULL);
+	util_fd_watch(inotify.fd, IRC_FD_READ, NULL, &util_inotify_cb, (void*)&core_ctx);
 
-	// check for patched lib with ircv3 tag parsing hack
-	{
-		unsigned irc_maj = 0, irc_min = 0;
-		irc_get_version(&irc_maj, &irc_min);
-		if(irc_maj == 1 && irc_min == 0x1b07){
-			have_tag_hack = 1;
-		}
+	if(ipc_ring){
+		util_fd_watch(ipc_eventfd, IRC_FD_READ, NULL, &util_ipc_cb, NULL);
 	}
 
+	sb_push(channels, 0);
+
 	// initial load of modules
 
 	util_reload_modules(&core_ctx);
@@ -1492,158 +5741,95 @@ int main(int argc, char** argv){
 	serv = util_env_else("IRC_SERV", "irc.nonexistent.domain");
 	port = util_env_else("IRC_PORT", "6667");
 	bot_nick = strdup(user);
+	unknown_log = !getenv("INSOBOT_NO_UNKNOWN_LOG");
 
-	static irc_callbacks_t callbacks = {
-		.event_connect     = irc_on_connect,
-		.event_channel     = irc_on_chat_msg,
-		.event_privmsg     = irc_on_pm,
-		.event_join        = irc_on_join,
-		.event_part        = irc_on_part,
-		.event_quit        = irc_on_quit,
-		.event_nick        = irc_on_nick,
-		.event_ctcp_action = irc_on_action,
-		.event_numeric     = irc_on_numeric,
-		.event_unknown     = irc_on_unknown,
-	};
+	util_rate_init();
+
+	SSL_library_init();
+	SSL_load_error_strings();
 
 	// outer main loop, (re)set irc state
 
 	do {
-		if(!(irc_ctx = irc_create_session(&callbacks))){
-			fprintf(stderr, "Failed to create irc session.\n");
-			exit(1);
-		}
-
-		irc_option_set(irc_ctx, LIBIRC_OPTION_STRIPNICKS);
-
-		char* libirc_serv;
-		if(getenv("IRC_ENABLE_SSL")){
+		bool use_ssl = getenv("IRC_ENABLE_SSL");
+		if(use_ssl){
 			puts("Using ssl connection...");
-			asprintf_check(&libirc_serv, "#%s", serv);
-
-			//XXX: you might not want this!
-			irc_option_set(irc_ctx, LIBIRC_OPTION_SSL_NO_VERIFY);
-		} else {
-			libirc_serv = strdup(serv);
 		}
 
-		if(irc_connect(irc_ctx, libirc_serv, atoi(port), pass, user, user, user) != 0){
-			fprintf(stderr, "Unable to connect: %s\n", irc_strerror(irc_errno(irc_ctx)));
-		}
-
-		free(libirc_serv);
+		util_irc_connect(serv, port, use_ssl);
 
 		// inner main loop
 
-		while(running && irc_is_connected(irc_ctx)){
+		while(running && irc_conn.state != IRC_STATE_DISCONNECTED){
 
+			util_process_events();
 			util_process_pending_cmds();
 
-			//TODO: check on_meta & better timing for on_tick?
-			time_t now = time(0);
-			IRC_MOD_CALL_ALL(on_tick, (now));
-
-			int max_fd = 0;
-			fd_set in, out;
-	
-			FD_ZERO(&in);
-			FD_ZERO(&out);
-
-			FD_SET(STDIN_FILENO, &in);
-			FD_SET(ipc_socket  , &in);
-			FD_SET(inotify.fd  , &in);
-
-			max_fd = INSO_MAX(max_fd, STDIN_FILENO);
-			max_fd = INSO_MAX(max_fd, ipc_socket);
-			max_fd = INSO_MAX(max_fd, inotify.fd);
+			util_timers_run();
 
-			if(debug_chan && debug_pipe[0]){
-				FD_SET(debug_pipe[0], &in);
-				max_fd = INSO_MAX(max_fd, debug_pipe[0]);
-			}
+			const int64_t now_ms = util_mono_ms();
+			const bool have_tick = sb_count(util_mod_subs(MOD_CB_SLOT(on_tick))) > 0;
 
-			if(irc_add_select_descriptors(irc_ctx, &in, &out, &max_fd) != 0){
-				fprintf(stderr, "Error adding select fds: %s\n", irc_strerror(irc_errno(irc_ctx)));
+			//TODO: check on_meta for on_tick?
+			if(have_tick && now_ms >= next_tick_ms){
+				IRC_MOD_CALL_ALL(on_tick, (time(0)));
+				next_tick_ms = now_ms + TICK_INTERVAL_MS;
 			}
 
-			struct timeval tv = {
-				.tv_sec  = 0,
-				.tv_usec = 250000,
-			}, orig_tv = tv;
+			util_irc_fd_update();
 
-			int select_status = select(max_fd + 1, &in, &out, NULL, &tv);
+			// sleep until the next thing that needs doing, or an fd wakes us up
+			struct epoll_event events[32];
+			int64_t wake_ms = irc_last_recv_ms + (ping_sent ? IRC_RESTART_MS : IRC_PING_MS);
 
-			if(select_status > 0){
+			if(have_tick){
+				wake_ms = INSO_MIN(wake_ms, next_tick_ms);
+			}
 
-				if(FD_ISSET(STDIN_FILENO, &in)){
-					FD_CLR(STDIN_FILENO, &in);
-					char stdin_buf[1024];
-					ssize_t n = read(STDIN_FILENO, stdin_buf, sizeof(stdin_buf));
-					if(n > 0){
-						stdin_buf[n-1] = 0; // remove \n
-						IRC_MOD_CALL_ALL(on_stdin, (stdin_buf));
-					}
-				}
+			if(http_timeout_ms != -1){
+				wake_ms = INSO_MIN(wake_ms, http_timeout_ms);
+			}
 
-				if(FD_ISSET(ipc_socket, &in)){
-					FD_CLR(ipc_socket, &in);
-					util_ipc_recv();
-				}
+			int64_t cmd_wait = util_cmd_next_wait();
+			if(cmd_wait != -1){
+				wake_ms = INSO_MIN(wake_ms, now_ms + cmd_wait);
+			}
 
-				if(FD_ISSET(inotify.fd, &in)){
-					FD_CLR(inotify.fd, &in);
-					util_inotify_check(&core_ctx);
-				}
+			if(util_events_pending()){
+				wake_ms = now_ms;
+			}
 
-				if(FD_ISSET(debug_pipe[0], &in)){
-					FD_CLR(debug_pipe[0], &in);
-					char buf[256];
-					char* fname;
-					int off;
-					size_t n = read(debug_pipe[0], buf, sizeof(buf)-1);
-
-					if(n > 0 && sscanf(buf, "%m[^(]%n", &fname, &off) == 1){
-						buf[n-1] = 0; // remove \n
-						core_send_msg(debug_chan, "Recovered from crash: %s%s", basename(fname), buf + off);
-						free(fname);
-					}
-				}
+			int64_t timer_wait = util_timer_next_wait();
+			if(timer_wait != -1){
+				wake_ms = INSO_MIN(wake_ms, now_ms + timer_wait);
+			}
 
-				for(int i = 0; i < max_fd + 1; ++i){
-					if(FD_ISSET(i, &in)){
-						timerclear(&idle_tv);
-						ping_sent = 0;
-						break;
-					}
-				}
+			int wait_ms = INSO_MAX(0, INSO_MIN(wake_ms - now_ms, INT_MAX));
+			int num_events = epoll_wait(epoll_fd, events, ARRAY_SIZE(events), wait_ms);
 
-				if(irc_process_select_descriptors(irc_ctx, &in, &out) != 0){
-					fprintf(stderr, "Error processing select fds: %s\n", irc_strerror(irc_errno(irc_ctx)));
+			if(num_events > 0){
+				for(int i = 0; i < num_events; ++i){
+					util_fd_dispatch(events[i].data.fd, events[i].events);
 				}
+			} else if(num_events == -1 && errno != EINTR){
+				perror("epoll_wait");
+			}
 
-			} else if(select_status == 0){
-
-				struct timeval ping_tv    = { .tv_sec = 60 };
-				struct timeval restart_tv = { .tv_sec = 90 };
-
-				timeradd(&orig_tv, &idle_tv, &idle_tv);
-
-				if(!ping_sent && timercmp(&idle_tv, &ping_tv, >)){
-					irc_send_raw(irc_ctx, "PING %s", serv);
-					ping_sent = 1;
-				} else if(ping_sent && timercmp(&idle_tv, &restart_tv, >)){
-					puts("Reached 'no PONG' threshold, disconnecting."); 
-					irc_disconnect(irc_ctx);
-				}
+			const int64_t idle_ms = util_mono_ms() - irc_last_recv_ms;
 
-			} else {
-				perror("select");
+			if(!ping_sent && idle_ms >= IRC_PING_MS){
+				util_irc_send("PING %s", serv);
+				ping_sent = true;
+			} else if(ping_sent && idle_ms >= IRC_RESTART_MS){
+				puts("Reached 'no PONG' threshold, disconnecting."); 
+				util_irc_disconnect();
 			}
+
+			util_http_tick();
 		}
-	
-		irc_destroy_session(irc_ctx);
-		timerclear(&idle_tv);
-		ping_sent = 0;
+
+		util_irc_disconnect();
+		ping_sent = false;
 
 		if(running){
 			puts("Restarting.");
@@ -1658,43 +5844,87 @@ int main(int argc, char** argv){
 	// clean stuff up so real leaks are more obvious in valgrind
 
 	for(Module* m = irc_modules; m < sb_end(irc_modules); ++m){
-		util_module_save(m);
-		IRC_MOD_CALL(m, on_quit, ());
+		if(m->init_state == MOD_INIT_READY){
+			util_module_save(m);
+		}
+		util_module_quit(m);
+		util_journal_close(m);
+		util_stats_free(m);
 		free(m->lib_path);
 		dlclose(m->lib_handle);
 		m->lib_handle = NULL;
 	}
 
+	util_async_quit();
+
+	util_cmd_index_free();
+	for(size_t i = 0; i < MOD_CB_COUNT; ++i){
+		sb_free(mod_subs[i]);
+	}
+	util_perm_cache_clear(NULL);
+	sb_free(perm_cache);
 	sb_free(irc_modules);
 	sb_free(chan_mod_list);
 	sb_free(global_mod_list);
 	sb_free(mod_call_stack);
-	sb_free(cmd_queue);
+	for(size_t i = 0; i < rate_target_table.size; ++i){
+		while(rate_target_table.buckets[i]){
+			util_target_bucket_free((TargetBucket*)rate_target_table.buckets[i]);
+		}
+	}
+	free(rate_target_table.buckets);
 	sb_free(irc_tag_ptrs);
+	sb_free(irc_tag_index);
+
+	while(sb_count(http_reqs)){
+		util_http_free(sb_last(http_reqs));
+	}
+	sb_free(http_reqs);
+
+	if(curl_multi){
+		curl_multi_cleanup(curl_multi);
+	}
 
 	curl_global_cleanup();
 
-	for(size_t i = 0; i < sb_count(channels) - 1; ++i){
-		free(channels[i]);
-		for(size_t j = 0; j < sb_count(chan_nicks[i]); ++j){
-			free(chan_nicks[i][j]);
-		}
-		sb_free(chan_nicks[i]);
+	sb_free(timers);
+	for(size_t i = 0; i < ARRAY_SIZE(event_queues); ++i){
+		sb_free(event_queues[i].events);
+		sb_free(event_queues[i].strings);
+	}
+	sb_free(irc_conn.out);
+	if(irc_conn.ssl_ctx){
+		SSL_CTX_free(irc_conn.ssl_ctx);
+	}
+
+	while(*channels){
+		util_chan_remove(util_chan_find(*channels));
 	}
 	sb_free(channels);
-	sb_free(chan_nicks);
+	free(chan_table.buckets);
+	free(nick_table.buckets);
+
+	for(size_t i = 0; i < intern_table.size; ++i){
+		IRCName* n = intern_table.buckets[i];
+		while(n){
+			IRCName* next = n->next;
+			free(n->name);
+			free(n);
+			n = next;
+		}
+	}
+	free(intern_table.buckets);
 
 	free(bot_nick);
 
 	free(inotify.module.path);
 	free(inotify.data.path);
-	free(inotify.ipc.path);
 
-	if(ipc_socket > 0){
-		close(ipc_socket);
-		unlink(ipc_self.addr.sun_path);
-	}
-	sb_free(ipc_peers);
+	util_ipc_quit();
+	util_log_quit();
+
+	sb_free(fd_watches);
+	close(epoll_fd);
 
 	if(pipe_fds[1]){
 		close(pipe_fds[1]);
@@ -2,13 +2,16 @@
 #include "config.h"
 #include "inso_utils.h"
 #include <string.h>
+#include <strings.h>
 #include <ctype.h>
+#include <inttypes.h>
 
 static bool admin_init (const IRCCoreCtx*);
 static void admin_cmd  (const char*, const char*, const char*, int);
 static void admin_stdin(const char*);
+static void admin_ipc  (int, const uint8_t*, size_t);
 
-enum { FORCE_JOIN };
+enum { FORCE_JOIN, CALL_STATS };
 
 const IRCModuleCtx irc_mod_ctx = {
 	.name     = "admin",
@@ -17,8 +20,10 @@ const IRCModuleCtx irc_mod_ctx = {
 	.on_init  = admin_init,
 	.on_cmd   = &admin_cmd,
 	.on_stdin = &admin_stdin,
+	.on_ipc   = &admin_ipc,
 	.commands = DEFINE_CMDS (
-		[FORCE_JOIN] = CONTROL_CHAR "fjoin " CONTROL_CHAR "join"
+		[FORCE_JOIN] = CONTROL_CHAR "fjoin " CONTROL_CHAR "join",
+		[CALL_STATS] = CONTROL_CHAR "modstats"
 	)
 };
 
@@ -29,6 +34,36 @@ static bool admin_init(const IRCCoreCtx* _ctx){
 	return true;
 }
 
+static const char* admin_fmt_ns(char* buf, size_t len, uint64_t ns){
+	if(ns < 1000){
+		snprintf(buf, len, "%" PRIu64 "ns", ns);
+	} else if(ns < 1000000){
+		snprintf(buf, len, "%.1fus", ns / 1e3);
+	} else if(ns < 1000000000){
+		snprintf(buf, len, "%.1fms", ns / 1e6);
+	} else {
+		snprintf(buf, len, "%.1fs", ns / 1e9);
+	}
+	return buf;
+}
+
+#define FMT_NS(ns) admin_fmt_ns((char[16]){}, 16, (ns))
+
+// fills out with stats for mod_name (or every module if NULL), returns how many it got.
+static size_t admin_get_stats(const char* mod_name, IRCCallStats* out, size_t max){
+	if(ctx->api_version < 15) return 0;
+	return INSO_MIN(ctx->get_call_stats(mod_name, out, max), max);
+}
+
+static void admin_stats_line(const IRCCallStats* st, char* buf, size_t len){
+	snprintf(
+		buf, len,
+		"%s/%s: %" PRIu64 " calls, %s total, p50 %s, p90 %s, p99 %s, max %s",
+		st->module, st->callback, st->count, FMT_NS(st->total_ns),
+		FMT_NS(st->p50_ns), FMT_NS(st->p90_ns), FMT_NS(st->p99_ns), FMT_NS(st->max_ns)
+	);
+}
+
 static void admin_cmd(const char* chan, const char* name, const char* arg, int cmd){
 
 	bool real_admin = strcmp(name, BOT_OWNER) == 0 || inso_is_admin(ctx, name);
@@ -51,9 +86,100 @@ static void admin_cmd(const char* chan, const char* name, const char* arg, int c
 			ctx->join(join_chan);
 
 		} break;
+
+		case CALL_STATS: {
+			IRCCallStats stats[3];
+			const char* mod_name = *arg ? arg + 1 : NULL;
+			size_t n = admin_get_stats(mod_name, stats, ARRAY_SIZE(stats));
+
+			if(n == 0){
+				ctx->send_msg(chan, "@%s: No calls recorded%s%s.", name, mod_name ? " for " : "", mod_name ? mod_name : "");
+				break;
+			}
+
+			char msg[512] = "";
+			char* p = msg;
+			size_t sz = sizeof(msg);
+
+			for(size_t i = 0; i < n; ++i){
+				snprintf_chain(
+					&p, &sz, "%s%s/%s %" PRIu64 "x p50 %s p99 %s max %s",
+					i ? " | " : "", stats[i].module, stats[i].callback, stats[i].count,
+					FMT_NS(stats[i].p50_ns), FMT_NS(stats[i].p99_ns), FMT_NS(stats[i].max_ns)
+				);
+			}
+
+			ctx->send_msg(chan, "@%s: %s", name, msg);
+		} break;
+	}
+}
+
+// replies to a "STATS <module|*>" IPC message with a "STATS_LINE <line>" for each callback.
+static void admin_ipc(int sender, const uint8_t* data, size_t data_len){
+	if(!memchr(data, 0, data_len)) return;
+
+	char mod[64];
+	const char* text = (const char*)data;
+
+	if(sscanf(text, "STATS %63s", mod) == 1){
+		IRCCallStats stats[64];
+		size_t n = admin_get_stats(strcmp(mod, "*") == 0 ? NULL : mod, stats, ARRAY_SIZE(stats));
+
+		for(size_t i = 0; i < n; ++i){
+			char line[256] = "STATS_LINE ";
+			admin_stats_line(stats + i, line + 11, sizeof(line) - 11);
+			ctx->send_ipc(sender, line, strlen(line) + 1);
+		}
+	} else if(strncmp(text, "STATS_LINE ", 11) == 0){
+		ctx->log("[%d] %s\n", sender, text + 11);
 	}
 }
 
 static void admin_stdin(const char* text){
-	// TODO: administrative stdin commands
+	// TODO: more administrative stdin commands
+
+	static const char* levels[] = IRC_LOG_LEVEL_NAMES;
+	char mod[64], level[16];
+
+	if(strncmp(text, "stats", 5) == 0 && (text[5] == '\0' || text[5] == ' ')){
+		IRCCallStats stats[64];
+		const char* mod_name = sscanf(text + 5, "%63s", mod) == 1 ? mod : NULL;
+		size_t n = admin_get_stats(mod_name, stats, mod_name ? ARRAY_SIZE(stats) : 20);
+
+		if(n == 0){
+			ctx->log("No calls recorded.\n");
+		}
+
+		for(size_t i = 0; i < n; ++i){
+			char line[256];
+			admin_stats_line(stats + i, line, sizeof(line));
+			ctx->log("%s\n", line);
+		}
+		return;
+	}
+
+	// asks the other instances for theirs, the replies are handled by admin_ipc
+	if(strncmp(text, "ipcstats", 8) == 0 && (text[8] == '\0' || text[8] == ' ')){
+		char msg[80];
+		snprintf(msg, sizeof(msg), "STATS %s", sscanf(text + 8, "%63s", mod) == 1 ? mod : "*");
+		ctx->send_ipc(0, msg, strlen(msg) + 1);
+		return;
+	}
+
+	if(sscanf(text, "loglevel %63s %15s", mod, level) == 2){
+		const char* mod_name = strcmp(mod, "core") == 0 ? NULL : mod;
+
+		for(size_t i = 0; i < ARRAY_SIZE(levels); ++i){
+			if(strcasecmp(level, levels[i]) != 0) continue;
+
+			if(ctx->set_log_level(mod_name, IRC_LOG_DEBUG + i)){
+				ctx->log("Log level for %s is now %s.\n", mod, levels[i]);
+			} else {
+				ctx->log("No module called %s.\n", mod);
+			}
+			return;
+		}
+
+		ctx->log("Unknown log level %s (debug, info, warn or error).\n", level);
+	}
 }
@@ -6,6 +6,7 @@
 #include <time.h>
 #include "stb_sb.h"
 #include "inso_utils.h"
+#include "module_msgs.h"
 
 //#define TRIGGER_HAPPY
 
@@ -15,6 +16,7 @@ static bool automod_init    (const IRCCoreCtx*);
 static void automod_join    (const char*, const char*);
 static void automod_connect (const char*);
 static void automod_quit    (void);
+static void automod_mod_msg (const char*, const IRCModMsg*);
 
 enum { AUTOMOD_TIMEOUT, AUTOMOD_UNBAN };
 
@@ -28,6 +30,7 @@ const IRCModuleCtx irc_mod_ctx = {
 	.on_connect = &automod_connect,
 	.on_join    = &automod_join,
 	.on_quit    = &automod_quit,
+	.on_mod_msg = &automod_mod_msg,
 	.commands   = DEFINE_CMDS(
 		[AUTOMOD_TIMEOUT] = "!b \\b !to !ko \\ko",
 		[AUTOMOD_UNBAN]   = "!ub \\ub"
@@ -36,25 +39,50 @@ const IRCModuleCtx irc_mod_ctx = {
 
 static const IRCCoreCtx* ctx;
 
+// channels are interned with ctx->intern, and names with ctx->intern_ref, so they can be compared by pointer
 typedef struct {
-	char*  name;
+	const char* name;
 	int    score;
 	time_t join;
 	time_t last_msg;
 	int    num_offences;
+	bool   awaiting_user_date; // posted a link, but mod_twitch is still looking up their account
 } Suspect;
 
-static char**    channels;
-static Suspect** suspects;
+static const char** channels;
+static Suspect**    suspects;
+
+// suspects that haven't joined or said anything for this long are forgotten, ones with offences are kept longer
+#define SUSPECT_IDLE_SECS  (60*60)
+#define OFFENDER_IDLE_SECS (24*60*60)
+#define SWEEP_INTERVAL_MS  (10*60*1000)
 
 static time_t init_time;
 static bool is_twitch;
 static regex_t url_regex;
 
+static void automod_sweep(int timer_id, void* arg){
+	time_t now = time(0);
+
+	for(Suspect** slist = suspects; slist < sb_end(suspects); ++slist){
+		for(size_t i = 0; i < sb_count(*slist); ++i){
+			Suspect* s = *slist + i;
+			time_t idle = now - INSO_MAX(s->join, s->last_msg);
+
+			if(idle < (s->num_offences ? OFFENDER_IDLE_SECS : SUSPECT_IDLE_SECS)) continue;
+
+			ctx->intern_release(s->name);
+			sb_erase(*slist, i);
+			--i;
+		}
+	}
+}
+
 static bool automod_init(const IRCCoreCtx* _ctx){
 	ctx = _ctx;
 	init_time = time(0);
 	is_twitch = true;
+	ctx->add_timer(SWEEP_INTERVAL_MS, SWEEP_INTERVAL_MS, &automod_sweep, NULL);
 	return regcomp(
 		&url_regex,
         "\\b(https?://[^[:space:]]+|[a-zA-Z0-9][a-zA-Z0-9\\-_]*\\.[A-Za-z]{2,5}(\\.[A-Za-z]{2,5})*([:space:]|$|/|#|:|\\?))",
@@ -65,14 +93,11 @@ static bool automod_init(const IRCCoreCtx* _ctx){
 static void automod_quit(void){
 	regfree(&url_regex);
 
-	for(char** c = channels; c < sb_end(channels); ++c){
-		free(*c);
-	}
 	sb_free(channels);
 
 	for(Suspect** slist = suspects; slist < sb_end(suspects); ++slist){
 		for(Suspect* s = *slist; s < sb_end(*slist); ++s){
-			free(s->name);
+			ctx->intern_release(s->name);
 		}
 		sb_free(*slist);
 	}
@@ -84,29 +109,33 @@ static void automod_connect(const char* serv){
 }
 
 static Suspect* get_suspect(const char* chan, const char* name){
+	chan = ctx->intern(chan);
+	name = ctx->intern_ref(name);
 
 	int index = -1;
 	for(size_t i = 0; i < sb_count(channels); ++i){
-		if(strcmp(chan, channels[i]) == 0){
+		if(chan == channels[i]){
 			index = i;
 			break;
 		}
 	}
 
 	if(index == -1){
-		sb_push(channels, strdup(chan));
+		sb_push(channels, chan);
 		sb_push(suspects, NULL);
 		index = sb_count(channels) - 1;
 	}
 
 	for(size_t i = 0; i < sb_count(suspects[index]); ++i){
-		if(strcmp(suspects[index][i].name, name) == 0){
+		if(suspects[index][i].name == name){
+			// it already holds a ref for this name
+			ctx->intern_release(name);
 			return suspects[index] + i;
 		}
 	}
 
 	Suspect s = {
-		.name = strdup(name)
+		.name = name
 	};
 
 	sb_push(suspects[index], s);
@@ -116,11 +145,13 @@ static Suspect* get_suspect(const char* chan, const char* name){
 static void automod_join(const char* chan, const char* name){
 
 	if(strcmp(name, ctx->get_username()) == 0){
+		chan = ctx->intern(chan);
+
 		for(size_t i = 0; i < sb_count(channels); ++i){
-			if(strcmp(channels[i], chan)) return;
+			if(channels[i] == chan) return;
 		}
 
-		sb_push(channels, strdup(chan));
+		sb_push(channels, chan);
 		sb_push(suspects, NULL);
 	} else {
 		Suspect* s = get_suspect(chan, name);
@@ -129,7 +160,7 @@ static void automod_join(const char* chan, const char* name){
 }
 
 #ifdef TRIGGER_HAPPY
-static int am_score_caps(const Suspect* s, const char* msg, size_t len){
+static int am_score_caps(Suspect* s, const char* msg, size_t len){
 	size_t num_caps = 0;
 
 	if(len < 10) return 0;
@@ -146,7 +177,7 @@ static int am_score_caps(const Suspect* s, const char* msg, size_t len){
 	#error "Your OS/compiler doesn't store a Unicode / UCS4 codepoint in a wchar_t :("
 #endif
 
-static int am_score_ascii_art(const Suspect* s, const char* msg, size_t len){
+static int am_score_ascii_art(Suspect* s, const char* msg, size_t len){
 	const char *ptr = msg, *end = msg + len;
 	mbstate_t state = {};
 	wchar_t codepoint, prev_codepoint = 0;
@@ -248,7 +279,7 @@ static intptr_t get_user_cb(intptr_t result, intptr_t arg){
 	return 0;
 }
 
-static int am_score_links(const Suspect* s, const char* msg, size_t len){
+static int am_score_links(Suspect* s, const char* msg, size_t len){
 	bool is_url = false;
 	regmatch_t match;
 
@@ -276,6 +307,12 @@ static int am_score_links(const Suspect* s, const char* msg, size_t len){
 			time_t user_created_date = 0;
 			MOD_MSG(ctx, "twitch_get_user_date", s->name, &get_user_cb, &user_created_date);
 
+			// no answer yet, automod_mod_msg finishes this check when it gets one
+			if(!user_created_date){
+				s->awaiting_user_date = true;
+				return 0;
+			}
+
 			printf("twitch user time: %zu\n", (size_t)(now - user_created_date));
 
 			if((now - user_created_date) < (24*60*60)){
@@ -288,7 +325,7 @@ static int am_score_links(const Suspect* s, const char* msg, size_t len){
 }
 
 #ifdef TRIGGER_HAPPY
-static int am_score_flood(const Suspect* s, const char* msg, size_t len){
+static int am_score_flood(Suspect* s, const char* msg, size_t len){
 	time_t now = time(0);
 
 	if((now - s->last_msg) < 5){
@@ -299,17 +336,12 @@ static int am_score_flood(const Suspect* s, const char* msg, size_t len){
 }
 #endif
 
-static int am_score_emotes(const Suspect* s, const char* msg, size_t len){
+static int am_score_emotes(Suspect* s, const char* msg, size_t len){
 	int emote_count = 0;
-	int i = 0;
-	const char *k, *v;
+	const char* v = ctx->get_tag_by_name("emotes");
 
-	while(ctx->get_tag(i++, &k, &v)){
-		if(strcmp(k, "emotes") != 0) continue;
-		for(; *v; ++v){
-			if(*v == ':' || *v == ',') ++emote_count;
-		}
-		break;
+	for(; v && *v; ++v){
+		if(*v == ':' || *v == ',') ++emote_count;
 	}
 
 	return emote_count >= 5 ? 100 : emote_count * 10;
@@ -355,7 +387,7 @@ static void automod_msg(const char* chan, const char* name, const char* msg){
 #ifdef TRIGGER_HAPPY
 	const char* rules[] = { "caps", "symbol spam", "flood", "emotes", "spambot?" };
 
-	int (*score_fns[])(const Suspect*, const char*, size_t) = {
+	int (*score_fns[])(Suspect*, const char*, size_t) = {
 		am_score_caps,
 		am_score_ascii_art,
 		am_score_flood,
@@ -365,7 +397,7 @@ static void automod_msg(const char* chan, const char* name, const char* msg){
 #else
 	const char* rules[] = { "symbol spam", "emotes", "spambot?" };
 
-	int (*score_fns[])(const Suspect*, const char*, size_t) = {
+	int (*score_fns[])(Suspect*, const char*, size_t) = {
 		am_score_ascii_art,
 		am_score_emotes,
 		am_score_links
@@ -403,6 +435,28 @@ static void automod_msg(const char* chan, const char* name, const char* msg){
 	}
 }
 
+static void automod_mod_msg(const char* sender, const IRCModMsg* msg){
+	if(strcmp(msg->cmd, "twitch_user_date") != 0) return;
+
+	const TwitchUserDate* user = (const TwitchUserDate*)msg->arg;
+	time_t now = time(0);
+
+	printf("twitch user time: %zu\n", (size_t)(now - user->created_at));
+
+	for(size_t i = 0; i < sb_count(channels); ++i){
+		for(Suspect* s = suspects[i]; s < sb_end(suspects[i]); ++s){
+			if(s->name != user->name || !s->awaiting_user_date) continue;
+
+			s->awaiting_user_date = false;
+
+			if((now - user->created_at) < (24*60*60)){
+				s->score += 500;
+				automod_discipline(s, channels[i], "spambot?");
+			}
+		}
+	}
+}
+
 static void automod_cmd(const char* chan, const char* name, const char* arg, int cmd){
 	if(!inso_is_admin(ctx, name)) return;
 
@@ -1,6 +1,7 @@
 #include "module.h"
 #include "config.h"
 #include "inso_utils.h"
+#include <stdlib.h>
 
 static bool brainfuck_init (const IRCCoreCtx*);
 static void brainfuck_cmd  (const char*, const char*, const char*, int);
@@ -20,9 +21,6 @@ const IRCModuleCtx irc_mod_ctx = {
 
 static const IRCCoreCtx* ctx;
 
-static char bf_mem[30000];
-static const char* bf_end = bf_mem + sizeof(bf_mem) - 1;
-
 #define MAX_CYCLES 500000
 
 #if 0
@@ -31,27 +29,38 @@ static const char* bf_end = bf_mem + sizeof(bf_mem) - 1;
 	#define BF_DBG(fmt, ...)
 #endif
 
+enum { BF_OK, BF_MAX_CYCLES, BF_INVALID };
+
+// programs are run by the core's worker threads, so everything they touch lives in here
+typedef struct {
+	char* chan;
+	char* name;
+	char* prog;
+	int   result;
+	char  output[512];
+	char  mem[30000];
+} BFJob;
+
 static bool brainfuck_init(const IRCCoreCtx* _ctx){
 	ctx = _ctx;
 	return true;
 }
 
-static void brainfuck_cmd(const char* chan, const char* name, const char* arg, int cmd){
-	if(cmd != BRAINFUCK_EXEC) return;
-	if(!inso_is_wlist(ctx, name)) return;
-	if(*arg++ != ' ') return;
+static void brainfuck_run(void* arg){
+	BFJob* job = arg;
+
+	char* const bf_mem = job->mem;
+	const char* bf_end = bf_mem + sizeof(job->mem) - 1;
 
-	const char* ip    = arg;
+	const char* ip    = job->prog;
 
-	const char* input = strchrnul(arg, ' ');
+	const char* input = strchrnul(job->prog, ' ');
 	const char* in_p  = *input ? input+1 : input;
 
-	char  output[512] = {};
+	char* output      = job->output;
 	char* out_p       = output;
 
-	char* p           = bf_mem + sizeof(bf_mem)/2;
-	
-	memset(bf_mem, 0, sizeof(bf_mem));
+	char* p           = bf_mem + sizeof(job->mem)/2;
 
 	int cycles = 0;
 	int nesting = 0;
@@ -66,7 +75,7 @@ static void brainfuck_cmd(const char* chan, const char* name, const char* arg, i
 
 			case '.': {
 				BF_DBG("out [%d]\n", *p);
-				if(out_p - output < isizeof(output) - 1){
+				if(out_p - output < isizeof(job->output) - 1){
 					*out_p++ = *p;
 				}
 			} break;
@@ -103,7 +112,7 @@ static void brainfuck_cmd(const char* chan, const char* name, const char* arg, i
 				if(n <= 0) goto invalid;
 
 				if(*p){
-					while(--ip != arg){
+					while(--ip != job->prog){
 						if(*ip == '['){
 							if(n == nesting) break;
 							else --n;
@@ -111,7 +120,7 @@ static void brainfuck_cmd(const char* chan, const char* name, const char* arg, i
 						if(*ip == ']') ++n;
 					}
 
-					if(ip == arg) goto invalid;
+					if(ip == job->prog) goto invalid;
 				} else {
 					--nesting;
 				}
@@ -132,14 +141,43 @@ static void brainfuck_cmd(const char* chan, const char* name, const char* arg, i
 	}
 
 done:
-	if(cycles == MAX_CYCLES){
-		ctx->send_msg(chan, "%s: max cycle count (%d) reached.", name, MAX_CYCLES);
-	} else {
-		ctx->send_msg(chan, "%s: Output: %s", name, output);
-	}
-
+	job->result = (cycles == MAX_CYCLES) ? BF_MAX_CYCLES : BF_OK;
 	return;
 
 invalid:
-	ctx->send_msg(chan, "%s: malformed program.", name);
+	job->result = BF_INVALID;
+}
+
+static void brainfuck_done(void* arg){
+	BFJob* job = arg;
+
+	if(!ctx->cancelled()) switch(job->result){
+		case BF_OK:
+			ctx->send_msg(job->chan, "%s: Output: %s", job->name, job->output);
+			break;
+		case BF_MAX_CYCLES:
+			ctx->send_msg(job->chan, "%s: max cycle count (%d) reached.", job->name, MAX_CYCLES);
+			break;
+		case BF_INVALID:
+			ctx->send_msg(job->chan, "%s: malformed program.", job->name);
+			break;
+	}
+
+	free(job->chan);
+	free(job->name);
+	free(job->prog);
+	free(job);
+}
+
+static void brainfuck_cmd(const char* chan, const char* name, const char* arg, int cmd){
+	if(cmd != BRAINFUCK_EXEC) return;
+	if(!inso_is_wlist(ctx, name)) return;
+	if(*arg++ != ' ') return;
+
+	BFJob* job = calloc(1, sizeof(*job));
+	job->chan = strdup(chan);
+	job->name = strdup(name);
+	job->prog = strdup(arg);
+
+	ctx->run_async(&brainfuck_run, &brainfuck_done, job);
 }
@@ -14,19 +14,18 @@ static bool hmh_init    (const IRCCoreCtx*);
 static void hmh_quit    (void);
 static void hmh_mod_msg (const char* sender, const IRCModMsg* msg);
 static void hmh_ipc     (int who, const uint8_t* ptr, size_t sz);
-static void hmh_tick    (time_t);
 
 enum { CMD_SCHEDULE, CMD_TIME, CMD_OWLBOT, CMD_OWL_Y, CMD_OWL_N, CMD_QA };
 
 const IRCModuleCtx irc_mod_ctx = {
 	.name       = "hmh",
 	.desc       = "Functionality specific to Handmade Hero",
+	.flags      = IRC_MOD_INIT_THREAD,
 	.on_cmd     = &hmh_cmd,
 	.on_init    = &hmh_init,
 	.on_quit    = &hmh_quit,
 	.on_mod_msg = &hmh_mod_msg,
 	.on_ipc     = &hmh_ipc,
-	.on_tick    = &hmh_tick,
 	.commands = DEFINE_CMDS (
 		[CMD_SCHEDULE] = CMD1"sched " CMD1"schedule",
 		[CMD_TIME]     = CMD1"tm "    CMD1"time "     CMD1"when " CMD1"next " CMD1"timer",
@@ -50,7 +49,7 @@ static time_t schedule_week;
 
 static char* tz_buf;
 
-static time_t owlbot_timer;
+static int    owlbot_timer; // id of the timer ending the vote, 0 if there isn't one
 static char** owlbot_voters;
 static int    owlbot_yea;
 static int    owlbot_nay;
@@ -475,8 +474,11 @@ static bool check_for_alias(const char* keys, const char* chan, const char* cc){
 
 #define HMH_MSG(...) ({ ctx->send_msg(irc_server == SERV_TWITCH ? "#handmade_hero" : "#hero", __VA_ARGS__); })
 
+static void hmh_owlbot_end(int timer_id, void* arg);
+
 static void hmh_owlbot_start(void){
-	owlbot_timer = time(0);
+	if(owlbot_timer) ctx->cancel_timer(owlbot_timer);
+	owlbot_timer = ctx->add_timer(60 * 1000, 0, &hmh_owlbot_end, NULL);
 	owlbot_yea = owlbot_nay = 0;
 	HMH_MSG("(/o.o): Owl vote started. Use !owly or !owln to vote whether or not to light The Owl and notify Casey of something important.");
 }
@@ -528,32 +530,30 @@ static void hmh_cmd(const char* chan, const char* name, const char* arg, int cmd
 	}
 }
 
-static void hmh_tick(time_t now){
-	if(owlbot_timer && now > owlbot_timer + 60){
-		if((owlbot_nay + owlbot_yea) >= 3){
-			if(owlbot_yea > owlbot_nay){
-				HMH_MSG("(/o.o): The owl will now be signalled. (votes: [Yea: %d, Nay: %d])", owlbot_yea, owlbot_nay);
-
-				if(irc_server == SERV_HMN){
-					size_t id = ctx->send_msg("#hero", "@Owlbot: By popular demand, please become illuminated.");
-					MOD_MSG(ctx, "filter_permit", id, NULL, NULL);
-				}
+static void hmh_owlbot_end(int timer_id, void* arg){
+	if((owlbot_nay + owlbot_yea) >= 3){
+		if(owlbot_yea > owlbot_nay){
+			HMH_MSG("(/o.o): The owl will now be signalled. (votes: [Yea: %d, Nay: %d])", owlbot_yea, owlbot_nay);
 
-			} else if(owlbot_nay > owlbot_yea){
-				HMH_MSG("(/x.x): The owl will not be lit. (votes: [Yea: %d, Nay: %d])", owlbot_yea, owlbot_nay);
-			} else {
-				HMH_MSG("(/o.o): It's a tie (%d votes each). The owl will remain unlit.", owlbot_yea);
+			if(irc_server == SERV_HMN){
+				size_t id = ctx->send_msg("#hero", "@Owlbot: By popular demand, please become illuminated.");
+				MOD_MSG(ctx, "filter_permit", id, NULL, NULL);
 			}
+
+		} else if(owlbot_nay > owlbot_yea){
+			HMH_MSG("(/x.x): The owl will not be lit. (votes: [Yea: %d, Nay: %d])", owlbot_yea, owlbot_nay);
 		} else {
-			HMH_MSG("(/x.x): Not enough votes after 60 seconds. Owl signal cancelled.");
+			HMH_MSG("(/o.o): It's a tie (%d votes each). The owl will remain unlit.", owlbot_yea);
 		}
+	} else {
+		HMH_MSG("(/x.x): Not enough votes after 60 seconds. Owl signal cancelled.");
+	}
 
-		sb_each(v, owlbot_voters){
-			free(*v);
-		}
-		sb_free(owlbot_voters);
-		owlbot_timer = 0;
+	sb_each(v, owlbot_voters){
+		free(*v);
 	}
+	sb_free(owlbot_voters);
+	owlbot_timer = 0;
 }
 
 static int ftw_cb(const char* path, const struct stat* st, int type){
@@ -20,7 +20,7 @@ enum { HMNINFO_UPDATE };
 const IRCModuleCtx irc_mod_ctx = {
 	.name    = "hmninfo",
 	.desc    = "Shows info about projects on HMN when referenced like ~project",
-	.flags   = IRC_MOD_GLOBAL,
+	.flags   = IRC_MOD_GLOBAL | IRC_MOD_INIT_THREAD,
 	.on_init = &hmninfo_init,
 	.on_quit = &hmninfo_quit,
 	.on_msg  = &hmninfo_msg,
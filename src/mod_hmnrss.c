@@ -13,7 +13,7 @@
 
 static bool hmnrss_init (const IRCCoreCtx*);
 static void hmnrss_quit (void);
-static void hmnrss_tick (time_t);
+static void hmnrss_check(int, void*);
 
 const IRCModuleCtx irc_mod_ctx = {
 	.name    = "hmnrss",
@@ -21,14 +21,12 @@ const IRCModuleCtx irc_mod_ctx = {
 	.flags   = IRC_MOD_GLOBAL,
 	.on_init = &hmnrss_init,
 	.on_quit = &hmnrss_quit,
-	.on_tick = &hmnrss_tick,
 };
 
 static const IRCCoreCtx* ctx;
-static CURL* curl;
+static bool  check_pending;
 static char* etag;
 static time_t latest_post;
-static time_t last_check;
 static regex_t url_regex;
 
 typedef struct {
@@ -59,11 +57,11 @@ static size_t etag_cb(char* buffer, size_t size, size_t nelem, void* arg){
 
 static bool hmnrss_init(const IRCCoreCtx* _ctx){
 	ctx = _ctx;
-	curl = curl_easy_init();
 #ifdef DEBUG_MODE
-	last_check = time(0) - 50;
+	ctx->add_timer(10 * 1000, 60 * 1000, &hmnrss_check, NULL);
 #else
-	last_check = latest_post = time(0);
+	latest_post = time(0);
+	ctx->add_timer(60 * 1000, 60 * 1000, &hmnrss_check, NULL);
 #endif
 	regcomp(&url_regex, "https://([^\\.]*)\\.?handmade\\.network/.*/[0-9]+", REG_ICASE | REG_EXTENDED);
 
@@ -71,7 +69,6 @@ static bool hmnrss_init(const IRCCoreCtx* _ctx){
 }
 
 static void hmnrss_quit(void){
-	curl_easy_cleanup(curl);
 	free(etag);
 	regfree(&url_regex);
 
@@ -142,24 +139,13 @@ static bool hmnrss_check_spam(const char* msg, time_t post_time, const char* mem
 	return false;
 }
 
-static void hmnrss_tick(time_t now){
-	if(now - last_check < 60) return;
-	last_check = now;
-
-	char* data = NULL;
-	inso_curl_reset(curl, RSS_URL, &data);
-	curl_easy_setopt(curl, CURLOPT_HEADERFUNCTION, &etag_cb);
-	struct curl_slist* headers = NULL;
-
-	if(etag){
-		char buf[1024];
-		snprintf(buf, sizeof(buf), "If-None-Match: %s", etag);
-		headers = curl_slist_append(NULL, buf);
-		curl_easy_setopt(curl, CURLOPT_HTTPHEADER, headers);
-	}
+static void hmnrss_check_done(const IRCHTTPResult* res, void* arg){
+	check_pending = false;
+	if(ctx->cancelled()) return;
 
 	time_t new_latest_post = latest_post;
-	long ret = inso_curl_perform(curl, &data);
+	long ret = res->status;
+	char* data = res->data;
 
 #ifdef DEBUG_MODE
 	printf("hmnrss: doing check...\n");
@@ -240,10 +226,28 @@ static void hmnrss_tick(time_t now){
 	}
 
 	latest_post = new_latest_post;
+}
+
+static void hmnrss_check(int timer_id, void* arg){
+	// a slow response shouldn't overlap with the next check
+	if(check_pending) return;
 
-	if(headers){
-		curl_slist_free_all(headers);
+	// the core takes this over, and replaces the write callback with its own
+	CURL* curl = inso_curl_init(RSS_URL, NULL);
+	curl_easy_setopt(curl, CURLOPT_HEADERFUNCTION, &etag_cb);
+
+	char buf[1024];
+	const char* headers[2] = {};
+
+	if(etag){
+		snprintf(buf, sizeof(buf), "If-None-Match: %s", etag);
+		headers[0] = buf;
 	}
 
-	sb_free(data);
+	IRCHTTPOpts opts = {
+		.curl    = curl,
+		.headers = headers,
+	};
+
+	check_pending = ctx->http_request(NULL, &opts, &hmnrss_check_done, NULL);
 }
@@ -51,23 +51,33 @@ static char* info_trim(const char* text, int maxlen){
 	return strndup(text, len);
 }
 
-static void info_fallback(const char* chan, const char* arg, CURL* curl){
-	char* data = NULL;
-	char* url;
+// the command's details, kept until the last request it needs is done
+typedef struct {
+	char* chan;
+	char* nick;
+	char* arg;
+	char* redir;
+} InfoReq;
+
+static void info_req_free(InfoReq* req){
+	free(req->chan);
+	free(req->nick);
+	free(req->arg);
+	free(req->redir);
+	free(req);
+}
 
-	{
-		char* query = curl_easy_escape(curl, arg, 0);
-		asprintf_check(&url, "https://duckduckgo.com/html/?q=%s&kl=wt-wt&kz=-1&kaf=1&kd=-1&k1=-1&t=insobot", query);
-		curl_free(query);
-	}
+static void info_fallback_done(const IRCHTTPResult* res, void* arg){
+	InfoReq* req = arg;
+	char* url = NULL;
 
-	inso_curl_reset(curl, url, &data);
-	inso_curl_perform(curl, &data);
-	free(url);
-	url = NULL;
+	if(ctx->cancelled()){
+		info_req_free(req);
+		return;
+	}
 
 	uintptr_t* tokens = calloc(0x2000, sizeof(*tokens));
-	ixt_tokenize(data, tokens, 0x2000, 0);
+	ixt_tokenize(res->data, tokens, 0x2000, 0);
 
 	char desc[512];
 	bool get_content = false;
@@ -92,53 +102,91 @@ static void info_fallback(const char* chan, const char* arg, CURL* curl){
 
 	if(url){
 		char* d = info_trim(desc, 175);
-		ctx->send_msg(chan, "%s %s", url, d);
+		ctx->send_msg(req->chan, "%s %s", url, d);
 		free(d);
 	} else {
-		ctx->send_msg(chan, "Sorry, no information found for '%s'.", arg);
+		ctx->send_msg(req->chan, "Sorry, no information found for '%s'.", req->arg);
 	}
+
+	info_req_free(req);
 }
 
-static const char* info_top_result(yajl_val results){
-	if(results->u.array.len > 0 && YAJL_IS_OBJECT(results->u.array.values[0])){
-		yajl_val result_link = yajl_tree_get(results->u.array.values[0], paths[P_FIRSTURL], yajl_t_string);
-		if(result_link){
-			return result_link->u.string;
-		}
+static void info_fallback(InfoReq* req){
+	char* url;
+
+	{
+		CURL* curl = curl_easy_init();
+		char* query = curl_easy_escape(curl, req->arg, 0);
+		asprintf_check(&url, "https://duckduckgo.com/html/?q=%s&kl=wt-wt&kz=-1&kaf=1&kd=-1&k1=-1&t=insobot", query);
+		curl_free(query);
+		curl_easy_cleanup(curl);
 	}
-	return NULL;
+
+	if(!ctx->http_request(url, NULL, &info_fallback_done, req)){
+		ctx->send_msg(req->chan, "Sorry, no information found for '%s'.", req->arg);
+		info_req_free(req);
+	}
+
+	free(url);
 }
 
-static void info_cmd(const char* chan, const char* nick, const char* arg, int cmd){
-	if(cmd != INFO_GET || !inso_is_wlist(ctx, nick)) return;
+static void info_redirect_done(const IRCHTTPResult* res, void* arg){
+	InfoReq* req = arg;
+	char* location = NULL;
 
-	if(!*arg++){
-		ctx->send_msg(chan, "What would you like info about, %s?", nick);
+	if(ctx->cancelled()){
+		info_req_free(req);
 		return;
 	}
 
-	if(strcasecmp(arg, "insobot") == 0){
-		ctx->send_msg(chan, "I'm an IRC bot written in C99 by insofaras: https://github.com/baines/insobot");
-		return;
+	curl_easy_getinfo(res->curl, CURLINFO_EFFECTIVE_URL, &location);
+
+	if(location){
+		ctx->send_msg(req->chan, "%s: %s", req->nick, location);
+	} else {
+		ctx->send_msg(req->chan, "%s: %s", req->nick, req->redir);
 	}
 
-	char* data = NULL;
-	char* url;
-	CURL* curl = curl_easy_init();
+	info_req_free(req);
+}
 
-	{
-		char* query = curl_easy_escape(curl, arg, 0);
-		asprintf_check(&url, "https://api.duckduckgo.com/?q=%s&format=json&no_html=1&skip_disambig=1&t=insobot", query);
-		curl_free(query);
+static void info_redirect(InfoReq* req, const char* redir){
+	req->redir = strdup(redir);
+
+	// only the final location is wanted, the core takes this over
+	CURL* curl = inso_curl_init(redir, NULL);
+	curl_easy_setopt(curl, CURLOPT_NOBODY, 1L);
+	curl_easy_setopt(curl, CURLOPT_FOLLOWLOCATION, 1L);
+
+	IRCHTTPOpts opts = { .curl = curl };
+
+	if(!ctx->http_request(NULL, &opts, &info_redirect_done, req)){
+		ctx->send_msg(req->chan, "%s: %s", req->nick, req->redir);
+		info_req_free(req);
 	}
+}
 
-	inso_curl_reset(curl, url, &data);
-	curl_easy_perform(curl);
-	free(url);
+static const char* info_top_result(yajl_val results){
+	if(results->u.array.len > 0 && YAJL_IS_OBJECT(results->u.array.values[0])){
+		yajl_val result_link = yajl_tree_get(results->u.array.values[0], paths[P_FIRSTURL], yajl_t_string);
+		if(result_link){
+			return result_link->u.string;
+		}
+	}
+	return NULL;
+}
 
-	sb_push(data, 0);
+static void info_done(const IRCHTTPResult* res, void* arg){
+	InfoReq* req = arg;
+	const char* chan = req->chan;
+	const char* nick = req->nick;
+
+	if(ctx->cancelled()){
+		info_req_free(req);
+		return;
+	}
 
-	yajl_val root     = yajl_tree_parse(data, NULL, 0);
+	yajl_val root     = yajl_tree_parse(res->data, NULL, 0);
 
 	yajl_val type     = yajl_tree_get(root, paths[P_TYPE]   , yajl_t_string);
 	yajl_val abstract = yajl_tree_get(root, paths[P_ABSTEXT], yajl_t_string);
@@ -146,8 +194,6 @@ static void info_cmd(const char* chan, const char* nick, const char* arg, int cm
 	yajl_val results  = yajl_tree_get(root, paths[P_RESULTS], yajl_t_array);
 	yajl_val related  = yajl_tree_get(root, paths[P_RELATED], yajl_t_array);
 
-	sb_free(data);
-
 	if(!root || !type || !abstract || !abs_url || !results || !related){
 		ctx->send_msg(chan, "Sorry, something went wrong getting information...");
 		goto exit;
@@ -156,12 +202,14 @@ static void info_cmd(const char* chan, const char* nick, const char* arg, int cm
 	switch(*type->u.string){
 
 		case 0: {
-			info_fallback(chan, arg, curl);
+			info_fallback(req);
+			req = NULL;
 		} break;
 
 		case 'D': {
 			char choices[512] = {};
 			const int limit = INSO_MIN(5u, related->u.array.len);
+			CURL* curl = curl_easy_init();
 
 			for(int i = 0; i < limit; ++i){
 				yajl_val link = yajl_tree_get(related->u.array.values[i], paths[P_FIRSTURL], yajl_t_string);
@@ -182,7 +230,8 @@ static void info_cmd(const char* chan, const char* nick, const char* arg, int cm
 				}
 			}
 
-			ctx->send_msg(chan, "'%s' could refer to: %s.", arg, choices);
+			curl_easy_cleanup(curl);
+			ctx->send_msg(chan, "'%s' could refer to: %s.", req->arg, choices);
 		} break;
 
 		case 'E': {
@@ -194,22 +243,8 @@ static void info_cmd(const char* chan, const char* nick, const char* arg, int cm
 				ctx->send_msg(chan, "%s", str);
 				free(str);
 			} else if(redir && *redir->u.string){
-				char* location = NULL;
-				inso_curl_reset(curl, redir->u.string, &data);
-
-				curl_easy_setopt(curl, CURLOPT_NOBODY, 1L);
-				curl_easy_setopt(curl, CURLOPT_FOLLOWLOCATION, 1L);
-
-				curl_easy_perform(curl);
-				sb_free(data);
-
-				curl_easy_getinfo(curl, CURLINFO_EFFECTIVE_URL, &location);
-
-				if(location){
-					ctx->send_msg(chan, "%s: %s", nick, location);
-				} else {
-					ctx->send_msg(chan, "%s: %s", nick, redir->u.string);
-				}
+				info_redirect(req, redir->u.string);
+				req = NULL;
 			} else {
 				const char* link = info_top_result(results);
 				if(!link)	link = abs_url->u.string;
@@ -217,7 +252,7 @@ static void info_cmd(const char* chan, const char* nick, const char* arg, int cm
 				if(link){
 					ctx->send_msg(chan, "%s: %s", nick, link);
 				} else {
-					ctx->send_msg(chan, "Sorry, I don't have any information about '%s.'", arg);
+					ctx->send_msg(chan, "Sorry, I don't have any information about '%s.'", req->arg);
 				}
 			}
 
@@ -234,9 +269,45 @@ static void info_cmd(const char* chan, const char* nick, const char* arg, int cm
 	}
 
 exit:
-	curl_easy_cleanup(curl);
+	// the fallback / redirect requests free it when they're done
+	if(req) info_req_free(req);
 	yajl_tree_free(root);
+}
+
+static void info_cmd(const char* chan, const char* nick, const char* arg, int cmd){
+	if(cmd != INFO_GET || !inso_is_wlist(ctx, nick)) return;
 
+	if(!*arg++){
+		ctx->send_msg(chan, "What would you like info about, %s?", nick);
+		return;
+	}
+
+	if(strcasecmp(arg, "insobot") == 0){
+		ctx->send_msg(chan, "I'm an IRC bot written in C99 by insofaras: https://github.com/baines/insobot");
+		return;
+	}
+
+	char* url;
+
+	{
+		CURL* curl = curl_easy_init();
+		char* query = curl_easy_escape(curl, arg, 0);
+		asprintf_check(&url, "https://api.duckduckgo.com/?q=%s&format=json&no_html=1&skip_disambig=1&t=insobot", query);
+		curl_free(query);
+		curl_easy_cleanup(curl);
+	}
+
+	InfoReq* req = calloc(1, sizeof(*req));
+	req->chan = strdup(chan);
+	req->nick = strdup(nick);
+	req->arg  = strdup(arg);
+
+	if(!ctx->http_request(url, NULL, &info_done, req)){
+		ctx->send_msg(chan, "Sorry, something went wrong getting information...");
+		info_req_free(req);
+	}
+
+	free(url);
 }
 
 static bool info_init(const IRCCoreCtx* _ctx){
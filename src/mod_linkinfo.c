@@ -390,54 +390,53 @@ void do_yt_playlist_info(const char* chan, const char* msg, regmatch_t* matches)
 	sb_free(data);
 }
 
-char* do_download(const char* url){
-	char* data = NULL;
-	CURL* curl = inso_curl_init(url, &data);
-	CURLcode curl_ret = curl_easy_perform(curl);
-	sb_push(data, 0);
-	curl_easy_cleanup(curl);
-
-	if(curl_ret == CURLE_OK){
-		return data;
-	} else {
-		sb_free(data);
-		return NULL;
+typedef struct {
+	char* chan;
+	const char* tag;
+	bool ograph;
+} TitleRequest;
+
+static void do_title_done(const IRCHTTPResult* res, void* arg){
+	TitleRequest* req = arg;
+	regex_t* regex = req->ograph ? &ograph_desc_regex : &generic_title_regex;
+	regmatch_t match[2];
+	int len = 0;
+
+	if(res->status > 0 &&
+		regexec(regex, res->data, 2, match, 0) == 0 &&
+		(len = (match[1].rm_eo - match[1].rm_so)) > 0
+	){
+		char* str = strndupa(res->data + match[1].rm_so, len);
+		html_unescape(str, len);
+		ctx->send_msg(req->chan, "↑ %s: [%s]", req->tag, str);
+	} else if(res->status < 0 && !ctx->cancelled()){
+		fprintf(stderr, "linkinfo: curl returned %ld: %s\n", -res->status, curl_easy_strerror(-res->status));
 	}
-}
 
-void do_generic_info(const char* chan, const char* url, const char* tag){
-	char* html;
-	regmatch_t title[2];
-	int title_len = 0;
+	free(req->chan);
+	free(req);
+}
 
-	fprintf(stderr, "linkinfo: Fetching title [%s]\n", url);
+static void do_title_request(const char* chan, const char* url, const char* tag, bool ograph){
+	TitleRequest* req = malloc(sizeof(*req));
+	req->chan   = strdup(chan);
+	req->tag    = tag;
+	req->ograph = ograph;
 
-	if((html = do_download(url)) &&
-		regexec(&generic_title_regex, html, 2, title, 0) == 0 &&
-		(title_len = (title[1].rm_eo - title[1].rm_so)) > 0
-	){
-		char* title_str = strndupa(html + title[1].rm_so, title_len);
-		html_unescape(title_str, title_len);
-		ctx->send_msg(chan, "↑ %s: [%s]", tag, title_str);
+	if(!ctx->http_request(url, NULL, &do_title_done, req)){
+		free(req->chan);
+		free(req);
 	}
+}
 
-	sb_free(html);
+void do_generic_info(const char* chan, const char* url, const char* tag){
+	fprintf(stderr, "linkinfo: Fetching title [%s]\n", url);
+	do_title_request(chan, url, tag, false);
 }
 
 void do_ograph_info(const char* chan, const char* url, const char* tag){
-	char* html;
-	regmatch_t desc[2];
-
 	fprintf(stderr, "linkinfo: Fetching og desc [%s]\n", url);
-
-	if((html = do_download(url)) && regexec(&ograph_desc_regex, html, 2, desc, 0) == 0){
-		int len = desc[1].rm_eo - desc[1].rm_so;
-		char* desc_str = strndupa(html + desc[1].rm_so, len);
-		html_unescape(desc_str, len);
-		ctx->send_msg(chan, "↑ %s: [%s]", tag, desc_str);
-	}
-
-	sb_free(html);
+	do_title_request(chan, url, tag, true);
 }
 
 static const char* url_path[]        = { "url", NULL };
@@ -42,12 +42,14 @@ const IRCModuleCtx irc_mod_ctx = {
 
 static const IRCCoreCtx* ctx;
 
-static char** channels;
-static char*** enabled_mods_for_chan;
+// interned with ctx->intern
+static const char** channels;
+static char***      enabled_mods_for_chan;
 
 static char*** get_enabled_modules(const char* chan){
+	chan = ctx->intern(chan);
 	for(size_t i = 0; i < sb_count(channels); ++i){
-		if(strcmp(channels[i], chan) == 0) return enabled_mods_for_chan + i;
+		if(channels[i] == chan) return enabled_mods_for_chan + i;
 	}
 	return NULL;
 }
@@ -59,7 +61,6 @@ static void free_all_strs(char** strs){
 }
 
 static void meta_quit(void){
-	free_all_strs(channels);
 	sb_free(channels);
 
 	for(size_t i = 0; i < sb_count(enabled_mods_for_chan); ++i){
@@ -97,7 +98,7 @@ static bool reload_file(void){
 		char* line_state = NULL;
 		char* word = strtok_r(line, " \t", &line_state);
 
-		sb_push(channels, strdup(word));
+		sb_push(channels, ctx->intern(word));
 		sb_push(enabled_mods_for_chan, 0);
 
 		while((word = strtok_r(NULL, " \t", &line_state))){
@@ -109,6 +110,7 @@ static bool reload_file(void){
 	}
 
 	sb_free(file_contents);
+	ctx->perms_changed(NULL);
 
 	return true;
 }
@@ -167,6 +169,7 @@ static void meta_cmd(const char* chan, const char* name, const char* arg, int cm
 						ctx->send_msg(chan, "%s: That module is already enabled here!", name);
 					} else {
 						sb_push(*our_mods, strdup(arg));
+						ctx->perms_changed(chan);
 						ctx->send_msg(chan, "%s: Enabled module %s.", name, arg);
 						ctx->save_me();
 					}
@@ -190,6 +193,7 @@ static void meta_cmd(const char* chan, const char* name, const char* arg, int cm
 					if(m){
 						free(*m);
 						sb_erase(*our_mods, m - *our_mods);
+						ctx->perms_changed(chan);
 						ctx->send_msg(chan, "%s: Disabled module %s.", name, (*all_mods)->name);
 						ctx->save_me();
 					} else {
@@ -236,7 +240,7 @@ static void meta_join(const char* chan, const char* name){
 	if(strcasecmp(name, ctx->get_username()) != 0) return;
 
 	if(!get_enabled_modules(chan)){
-		sb_push(channels, strdup(chan));
+		sb_push(channels, ctx->intern(chan));
 		sb_push(enabled_mods_for_chan, 0);
 
 		for(IRCModuleCtx** m = ctx->get_modules(true); *m; ++m){
@@ -244,6 +248,8 @@ static void meta_join(const char* chan, const char* name){
 				sb_push(sb_last(enabled_mods_for_chan), strdup((*m)->name));
 			}
 		}
+
+		ctx->perms_changed(chan);
 	}
 }
 
@@ -32,9 +32,31 @@ typedef struct Note {
 	char*  content;
 } Note;
 
-static Note notes[256];
+#define NUM_NOTES 256
+
+static Note notes[NUM_NOTES];
 static int note_index;
 
+// a copy of the notes kept in warm restart memory, so they aren't lost if the bot crashes.
+#define WARM_NOTES_VERSION 1
+
+typedef struct WarmNote_ {
+	int    type;
+	time_t time;
+	char   channel[64];
+	char   author[64];
+	char   content[256];
+} WarmNote;
+
+typedef struct WarmNotes_ {
+	int      index;
+	WarmNote notes[NUM_NOTES];
+} WarmNotes;
+
+static WarmNotes* warm_notes;
+
+static const IRCCoreCtx* ctx;
+
 static void note_push(Note* new_note){
 
 	Note* n = notes + note_index;
@@ -46,13 +68,45 @@ static void note_push(Note* new_note){
 
 	*n = *new_note;
 
+	if(warm_notes){
+		WarmNote* w = warm_notes->notes + note_index;
+		w->type = n->type;
+		w->time = n->time;
+		snprintf(w->channel, sizeof(w->channel), "%s", n->channel);
+		snprintf(w->author , sizeof(w->author) , "%s", n->author);
+		snprintf(w->content, sizeof(w->content), "%s", n->content);
+	}
+
 	note_index = (note_index + 1) % ARRAY_SIZE(notes);
-}
 
-static const IRCCoreCtx* ctx;
+	if(warm_notes){
+		warm_notes->index = note_index;
+		ctx->warm_commit(warm_notes);
+	}
+}
 
 static bool notes_init(const IRCCoreCtx* _ctx){
 	ctx = _ctx;
+
+	bool restored;
+	warm_notes = ctx->warm_get("notes", sizeof(*warm_notes), WARM_NOTES_VERSION, &restored);
+
+	if(restored){
+		for(size_t i = 0; i < ARRAY_SIZE(notes); ++i){
+			WarmNote* w = warm_notes->notes + i;
+			if(w->type == NOTE_NONE) continue;
+
+			notes[i] = (Note){
+				.type    = w->type,
+				.time    = w->time,
+				.channel = strndup(w->channel, sizeof(w->channel)),
+				.author  = strndup(w->author , sizeof(w->author)),
+				.content = strndup(w->content, sizeof(w->content)),
+			};
+		}
+		note_index = warm_notes->index % ARRAY_SIZE(notes);
+	}
+
 	return true;
 }
 
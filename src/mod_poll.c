@@ -40,14 +40,14 @@ typedef struct {
 } PollOpt;
 
 typedef struct {
-	int      id;
-	char*    chan;
-	char*    question;
-	PollOpt* options;
-	char**   voters;
-	time_t   creation;
-	time_t   modified;
-	bool     open;
+	int          id;
+	char*        chan;
+	char*        question;
+	PollOpt*     options;
+	const char** voters; // interned with ctx->intern_ref
+	time_t       creation;
+	time_t       modified;
+	bool         open;
 } Poll;
 
 static Poll* poll_list;
@@ -225,8 +225,10 @@ static void poll_cmd(const char* chan, const char* name, const char* arg, int cm
 			if(poll && poll->open && vote >= 0 && vote < sb_count(poll->options)){
 				bool can_vote = true;
 
-				for(char** voter = poll->voters; voter < sb_end(poll->voters); ++voter){
-					if(strcmp(name, *voter) == 0){
+				const char* voter_name = ctx->intern_ref(name);
+
+				for(const char** voter = poll->voters; voter < sb_end(poll->voters); ++voter){
+					if(*voter == voter_name){
 						can_vote = false;
 						break;
 					}
@@ -234,11 +236,12 @@ static void poll_cmd(const char* chan, const char* name, const char* arg, int cm
 
 				if(can_vote){
 					poll->options[vote].votes++;
-					sb_push(poll->voters, strdup(name));
+					sb_push(poll->voters, voter_name);
 					ctx->save_me();
 
 					ctx->send_msg(name, "Your vote for [%s] was counted successfully.", poll->options[vote].text);
 				} else {
+					ctx->intern_release(voter_name);
 					ctx->send_msg(name, "You've already voted on poll #%d.", poll->id);
 				}
 			} else if(!poll){
@@ -308,22 +311,29 @@ static void poll_cmd(const char* chan, const char* name, const char* arg, int cm
 }
 
 static void poll_nick(const char* prev, const char* cur){
+	prev = ctx->intern_ref(prev);
+	cur  = ctx->intern_ref(cur);
+
 	sb_each(poll, poll_list){
 		if(!poll->open) continue;
 
 		sb_each(v, poll->voters){
-			if(strcmp(*v, cur) == 0){
-				return;
+			if(*v == cur){
+				goto end;
 			}
 		}
 
 		sb_each(v, poll->voters){
-			if(strcmp(*v, prev) == 0){
-				sb_push(poll->voters, strdup(cur));
+			if(*v == prev){
+				sb_push(poll->voters, ctx->intern_ref(cur));
 				break;
 			}
 		}
 	}
+
+end:
+	ctx->intern_release(prev);
+	ctx->intern_release(cur);
 }
 
 static bool poll_load(void){
@@ -407,7 +417,7 @@ static bool poll_load(void){
 		for(size_t j = 0; j < voters->u.array.len; ++j){
 			yajl_val v = voters->u.array.values[j];
 			if(!YAJL_IS_STRING(v)) goto end;
-			sb_push(poll.voters, strdup(v->u.string));
+			sb_push(poll.voters, ctx->intern_ref(v->u.string));
 		}
 
 		sb_push(poll_list, poll);
@@ -489,7 +499,7 @@ static void poll_quit(void){
 		sb_free(p->options);
 
 		sb_each(v, p->voters){
-			free(*v);
+			ctx->intern_release(*v);
 		}
 		sb_free(p->voters);
 	}
@@ -12,7 +12,7 @@ static void psa_add  (const char*, const char*, bool);
 static bool psa_init (const IRCCoreCtx*);
 static void psa_cmd  (const char*, const char*, const char*, int);
 static void psa_msg  (const char*, const char*, const char*);
-static void psa_tick (time_t);
+static void psa_check(int, void*);
 static bool psa_save (FILE*);
 static void psa_quit (void);
 
@@ -24,7 +24,6 @@ const IRCModuleCtx irc_mod_ctx = {
 	.on_init  = &psa_init,
 	.on_cmd   = &psa_cmd,
 	.on_msg   = &psa_msg,
-	.on_tick  = &psa_tick,
 	.on_save  = &psa_save,
 	.on_quit  = &psa_quit,
 	.commands = DEFINE_CMDS (
@@ -48,7 +47,6 @@ typedef struct {
 } PSAData;
 
 static PSAData* psa_data;
-static time_t psa_last_update;
 
 static bool psa_init(const IRCCoreCtx* _ctx){
 	ctx = _ctx;
@@ -64,6 +62,8 @@ static bool psa_init(const IRCCoreCtx* _ctx){
 
 	fclose(file);
 
+	ctx->add_timer(0, 60 * 1000, &psa_check, NULL);
+
 	return true;
 }
 
@@ -302,9 +302,8 @@ static void psa_msg(const char* chan, const char* name, const char* msg){
 
 }
 
-static void psa_tick(time_t now){
-	if(now - psa_last_update < 60) return;
-	psa_last_update = now;
+static void psa_check(int timer_id, void* arg){
+	time_t now = time(0);
 
 	for(PSAData* p = psa_data; p < sb_end(psa_data); ++p){
 		if(now - p->last_posted > p->freq_mins * 60 && !p->trigger){
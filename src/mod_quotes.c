@@ -11,18 +11,23 @@ static void quotes_modified (void);
 static void quotes_cmd      (const char*, const char*, const char*, int);
 static void quotes_quit     (void);
 static void quotes_ipc      (int, const uint8_t*, size_t);
+static void* quotes_export  (size_t*, uint32_t*);
+static bool quotes_import   (const IRCCoreCtx*, const void*, size_t, uint32_t);
 
 enum { GET_QUOTE, ADD_QUOTE, DEL_QUOTE, FIX_QUOTE, FIX_TIME, LIST_QUOTES, SEARCH_QUOTES, GET_RANDOM };
 
 const IRCModuleCtx irc_mod_ctx = {
-	.name        = "quotes",
-	.desc        = "Saves per-channel quotes",
-	.on_init     = &quotes_init,
-	.on_modified = &quotes_modified,
-	.on_cmd      = &quotes_cmd,
-	.on_quit     = &quotes_quit,
-	.on_ipc      = &quotes_ipc,
-	.commands    = DEFINE_CMDS (
+	.name            = "quotes",
+	.desc            = "Saves per-channel quotes",
+	.flags           = IRC_MOD_INIT_THREAD,
+	.on_init         = &quotes_init,
+	.on_modified     = &quotes_modified,
+	.on_cmd          = &quotes_cmd,
+	.on_quit         = &quotes_quit,
+	.on_ipc          = &quotes_ipc,
+	.on_export_state = &quotes_export,
+	.on_import_state = &quotes_import,
+	.commands        = DEFINE_CMDS (
 		[GET_QUOTE]     = CONTROL_CHAR"q    "CONTROL_CHAR"quote",
 		[ADD_QUOTE]     = CONTROL_CHAR"qadd "CONTROL_CHAR"q+ " CONTROL_CHAR"addquote",
 		[DEL_QUOTE]     = CONTROL_CHAR"qdel "CONTROL_CHAR"q- " CONTROL_CHAR"delquote",
@@ -48,6 +53,29 @@ typedef struct Quote_ {
 static char** channels;
 static Quote** chan_quotes;
 
+// gist loads and saves happen on run_async workers, one job at a time. The work takes inso_gist_lock and the job's
+// last done callback releases it, so a second job waiting on the lock can't hold up the done that would release it.
+enum { QUOTES_JOB_RELOAD = -1, QUOTES_JOB_IPC_ADD = -2 };
+
+typedef struct {
+	int   cmd;         // on_cmd's cmd, or one of the QUOTES_JOB_* values above
+	char  chan[64];
+	char  name[128];   // display name
+	char* arg;
+	bool  is_wlist;
+	bool  has_cmd_perms;
+	int   ipc_id;      // quote id for QUOTES_JOB_IPC_ADD
+	char  ipc[256];    // sent to other instances once the upload is done
+	bool  locked;
+	int   load_ret;
+	inso_gist_file* files;
+	inso_gist_file* upload;
+} QuotesJob;
+
+static QuotesJob*  gist_job;    // the one that's running
+static QuotesJob** gist_queue;  // waiting for it to finish
+static inso_gist_file* quotes_unsaved; // built by quotes_upload, taken by the running job to save
+
 static char* gen_escaped_csv(Quote* quotes){
 	char* csv = NULL;
 
@@ -155,14 +183,45 @@ static void quotes_free(void){
 	sb_free(chan_quotes);
 }
 
+static void quotes_job_free(QuotesJob* job){
+	if(job->locked){
+		inso_gist_unlock(gist);
+	}
+	inso_gist_file_free(job->files);
+	inso_gist_file_free(job->upload);
+	free(job->arg);
+	free(job);
+}
+
 static void quotes_quit(void){
 	quotes_free();
-	inso_gist_close(gist);
 	free(gist_pub_url);
+
+	for(QuotesJob** j = gist_queue; j < sb_end(gist_queue); ++j){
+		quotes_job_free(*j);
+	}
+	sb_free(gist_queue);
+
+	inso_gist_file_free(quotes_unsaved);
+	quotes_unsaved = NULL;
+
+	// a running job might hold the lock, it's closed once that job is cancelled instead.
+	if(!gist_job){
+		inso_gist_close(gist);
+	}
 }
 
+// the files are saved by the gist job that's running, after the command that changed them.
 static void quotes_upload(int modified_index){
 	inso_gist_file* file = NULL;
+
+	// something else is still waiting to be saved, so include it
+	if(quotes_unsaved){
+		inso_gist_file_free(quotes_unsaved);
+		quotes_unsaved = NULL;
+		modified_index = -1;
+	}
+
 	inso_gist_file_add(&file, " Quote List", "Here are the quotes stored by insobot, in csv format, one file per channel. Times are UTC.");
 
 	if(modified_index == -1){ // full upload
@@ -185,14 +244,11 @@ static void quotes_upload(int modified_index){
 		}
 	}
 
-	inso_gist_save(gist, "IRC quotes", file);
-	inso_gist_file_free(file);
+	quotes_unsaved = file;
 }
 
-static bool quotes_reload(void){
-	inso_gist_file* files = NULL;
-	int ret = inso_gist_load(gist, &files);
-
+// ret and files are from inso_gist_load, the caller frees files.
+static bool quotes_apply(int ret, inso_gist_file* files){
 	if(ret == INSO_GIST_304){
 		puts("mod_quotes: not modified.");
 		return true;
@@ -215,12 +271,21 @@ static bool quotes_reload(void){
 		load_csv(f->content, &sb_last(chan_quotes));
 	}
 
+	return true;
+}
+
+// only for on_init, which is on its own thread.
+static bool quotes_reload(void){
+	inso_gist_file* files = NULL;
+	int ret = inso_gist_load(gist, &files);
+
+	bool ok = quotes_apply(ret, files);
 	inso_gist_file_free(files);
 
-	return true;
+	return ok;
 }
 
-static bool quotes_init(const IRCCoreCtx* _ctx){
+static bool quotes_setup(const IRCCoreCtx* _ctx){
 	ctx = _ctx;
 
 	char* gist_id = getenv("INSOBOT_GIST_ID");
@@ -245,11 +310,128 @@ static bool quotes_init(const IRCCoreCtx* _ctx){
 
 	gist = inso_gist_open(gist_id, gist_user, gist_token);
 
-	return quotes_reload();
+	return true;
+}
+
+static bool quotes_init(const IRCCoreCtx* _ctx){
+	return quotes_setup(_ctx) && quotes_reload();
+}
+
+// handed over to the new instance on a hot reload, so it doesn't have to download the gist again.
+// it's serialised as: u32 channel count, then for each: name\0, u32 quote count, then for each: u32 id, i64 time, text\0.
+// bump QUOTES_STATE_VERSION if this changes.
+#define QUOTES_STATE_VERSION 2
+
+static void quotes_put(char** p, const void* data, size_t len){
+	memcpy(*p, data, len);
+	*p += len;
+}
+
+static bool quotes_get(const char** p, const char* end, void* out, size_t len){
+	if((size_t)(end - *p) < len) return false;
+	memcpy(out, *p, len);
+	*p += len;
+	return true;
+}
+
+static const char* quotes_get_str(const char** p, const char* end){
+	const char* str = *p;
+	const char* nul = memchr(str, 0, end - str);
+	if(!nul) return NULL;
+	*p = nul + 1;
+	return str;
+}
+
+static void* quotes_export(size_t* len, uint32_t* version){
+	size_t size = sizeof(uint32_t);
+
+	for(size_t i = 0; i < sb_count(channels); ++i){
+		size += strlen(channels[i]) + 1 + sizeof(uint32_t);
+		for(Quote* q = chan_quotes[i]; q < sb_end(chan_quotes[i]); ++q){
+			size += sizeof(uint32_t) + sizeof(int64_t) + strlen(q->text) + 1;
+		}
+	}
+
+	char* state = malloc(size);
+	if(!state) return NULL;
+
+	char* p = state;
+	uint32_t num_chans = sb_count(channels);
+	quotes_put(&p, &num_chans, sizeof(num_chans));
+
+	for(size_t i = 0; i < sb_count(channels); ++i){
+		quotes_put(&p, channels[i], strlen(channels[i]) + 1);
+
+		uint32_t num_quotes = sb_count(chan_quotes[i]);
+		quotes_put(&p, &num_quotes, sizeof(num_quotes));
+
+		for(Quote* q = chan_quotes[i]; q < sb_end(chan_quotes[i]); ++q){
+			int64_t timestamp = q->timestamp;
+			quotes_put(&p, &q->id, sizeof(q->id));
+			quotes_put(&p, &timestamp, sizeof(timestamp));
+			quotes_put(&p, q->text, strlen(q->text) + 1);
+		}
+	}
+
+	*len     = size;
+	*version = QUOTES_STATE_VERSION;
+	return state;
+}
+
+static bool quotes_import(const IRCCoreCtx* _ctx, const void* data, size_t len, uint32_t version){
+	if(version != QUOTES_STATE_VERSION) return false;
+
+	const char* p   = data;
+	const char* end = p + len;
+	uint32_t num_chans;
+
+	if(!quotes_get(&p, end, &num_chans, sizeof(num_chans))) return false;
+
+	for(uint32_t i = 0; i < num_chans; ++i){
+		const char* chan = quotes_get_str(&p, end);
+		uint32_t num_quotes;
+
+		if(!chan || !quotes_get(&p, end, &num_quotes, sizeof(num_quotes))) goto fail;
+
+		sb_push(channels, strdup(chan));
+		sb_push(chan_quotes, 0);
+
+		for(uint32_t j = 0; j < num_quotes; ++j){
+			Quote q;
+			int64_t timestamp;
+			const char* text;
+
+			if(
+				!quotes_get(&p, end, &q.id, sizeof(q.id)) ||
+				!quotes_get(&p, end, &timestamp, sizeof(timestamp)) ||
+				!(text = quotes_get_str(&p, end))
+			){
+				goto fail;
+			}
+
+			q.timestamp = timestamp;
+			q.text      = strdup(text);
+			sb_push(sb_last(chan_quotes), q);
+		}
+	}
+
+	if(quotes_setup(_ctx)) return true;
+
+fail:
+	quotes_free();
+	return false;
+}
+
+static void quotes_job_start(QuotesJob* job);
+
+static QuotesJob* quotes_job_new(int cmd){
+	QuotesJob* job = calloc(1, sizeof(*job));
+	job->cmd = cmd;
+	return job;
 }
 
 static void quotes_modified(void){
-	printf("RELOAD: %d\n", quotes_reload());
+	quotes_job_start(quotes_job_new(QUOTES_JOB_RELOAD));
 }
 
 static Quote* quote_get(const char* chan, unsigned int id){
@@ -337,24 +519,24 @@ static void quotes_notify(const char* chan, const char* name, Quote* q){
 	}
 }
 
-static void quotes_cmd(const char* chan, const char* name, const char* arg, int cmd){
+// runs the command once the job has reloaded the quotes
+static void quotes_cmd_run(QuotesJob* job){
+	const char* chan = job->chan;
+	const char* name = job->name;
+	const char* arg  = job->arg;
+	const int cmd    = job->cmd;
 
-	bool is_wlist = inso_is_wlist(ctx, name);
-	bool has_cmd_perms = strcasecmp(chan+1, name) == 0 || is_wlist;
+	const bool is_wlist      = job->is_wlist;
+	const bool has_cmd_perms = job->has_cmd_perms;
 
 	bool empty_arg = !*arg;
 	if(!empty_arg) ++arg;
 
-	inso_gist_lock(gist);
-	quotes_reload();
-
 	bool same_chan;
 	Quote** quotes;
 
 	const char* quote_chan = quotes_get_chan(chan, &arg, &quotes, &same_chan);
 
-	name = inso_dispname(ctx, name);
-
 	switch(cmd){
 		case GET_QUOTE: {
 			if(!empty_arg){
@@ -413,9 +595,7 @@ static void quotes_cmd(const char* chan, const char* name, const char* arg, int
 			quotes_upload(quotes - chan_quotes);
 
 			// notify other instances so they can also send messages to the affected channel
-			char ipc_buf[256];
-			int ipc_len = snprintf(ipc_buf, sizeof(ipc_buf), "ADD %d %s %s", id, quote_chan, name);
-			ctx->send_ipc(0, ipc_buf, ipc_len + 1);
+			snprintf(job->ipc, sizeof(job->ipc), "ADD %d %s %s", id, quote_chan, name);
 		} break;
 
 		case DEL_QUOTE: {
@@ -593,8 +773,86 @@ static void quotes_cmd(const char* chan, const char* name, const char* arg, int
 
 		} break;
 	}
+}
+
+static void quotes_gist_work(void* arg){
+	QuotesJob* job = arg;
+
+	if(!job->locked){
+		inso_gist_lock(gist);
+		job->locked = true;
+	}
 
-	inso_gist_unlock(gist);
+	if(job->upload){
+		inso_gist_save(gist, "IRC quotes", job->upload);
+	} else {
+		job->load_ret = inso_gist_load(gist, &job->files);
+	}
+}
+
+static void quotes_gist_done(void* arg){
+	QuotesJob* job = arg;
+
+	// only the running job can be cancelled, and quotes_quit left the gist open for it
+	if(ctx->cancelled()){
+		quotes_job_free(job);
+		gist_job = NULL;
+		inso_gist_close(gist);
+		return;
+	}
+
+	if(!job->upload){
+		// changes that haven't been saved yet win over the gist
+		bool ok = quotes_unsaved || quotes_apply(job->load_ret, job->files);
+
+		if(job->cmd == QUOTES_JOB_RELOAD){
+			printf("RELOAD: %d\n", ok);
+		} else if(job->cmd == QUOTES_JOB_IPC_ADD){
+			quotes_notify(job->chan, job->name, quote_get(job->chan, job->ipc_id));
+		} else {
+			quotes_cmd_run(job);
+		}
+
+		if(quotes_unsaved){
+			job->upload = quotes_unsaved;
+			quotes_unsaved = NULL;
+			ctx->run_async(&quotes_gist_work, &quotes_gist_done, job);
+			return;
+		}
+	} else if(*job->ipc){
+		ctx->send_ipc(0, job->ipc, strlen(job->ipc) + 1);
+	}
+
+	quotes_job_free(job);
+	gist_job = NULL;
+
+	if(sb_count(gist_queue)){
+		QuotesJob* next = gist_queue[0];
+		sb_erase(gist_queue, 0);
+		quotes_job_start(next);
+	}
+}
+
+static void quotes_job_start(QuotesJob* job){
+	if(gist_job){
+		sb_push(gist_queue, job);
+	} else {
+		gist_job = job;
+		ctx->run_async(&quotes_gist_work, &quotes_gist_done, job);
+	}
+}
+
+static void quotes_cmd(const char* chan, const char* name, const char* arg, int cmd){
+	QuotesJob* job = quotes_job_new(cmd);
+
+	job->is_wlist      = inso_is_wlist(ctx, name);
+	job->has_cmd_perms = strcasecmp(chan+1, name) == 0 || job->is_wlist;
+	job->arg           = strdup(arg);
+
+	*stpncpy(job->chan, chan                   , sizeof(job->chan)-1) = 0;
+	*stpncpy(job->name, inso_dispname(ctx, name), sizeof(job->name)-1) = 0;
+
+	quotes_job_start(job);
 }
 
 static void quotes_ipc(int sender, const uint8_t* data, size_t data_len){
@@ -605,8 +863,13 @@ static void quotes_ipc(int sender, const uint8_t* data, size_t data_len){
 	int name_offset = 0;
 
 	if(sscanf(data, "ADD %d %ms %n", &id, &chan, &name_offset) == 2){
-		quotes_reload();
-		quotes_notify(chan, data + name_offset, quote_get(chan, id));
+		QuotesJob* job = quotes_job_new(QUOTES_JOB_IPC_ADD);
+		job->ipc_id = id;
+
+		*stpncpy(job->chan, chan              , sizeof(job->chan)-1) = 0;
+		*stpncpy(job->name, data + name_offset, sizeof(job->name)-1) = 0;
+
+		quotes_job_start(job);
 	}
 
 	free(chan);
@@ -12,7 +12,6 @@
 
 static bool sched_init (const IRCCoreCtx*);
 static void sched_cmd  (const char*, const char*, const char*, int);
-static void sched_tick (time_t);
 static void sched_quit (void);
 static void sched_mod_msg (const char*, const IRCModMsg*);
 
@@ -23,7 +22,6 @@ const IRCModuleCtx irc_mod_ctx = {
 	.desc        = "Stores stream schedules",
 	.on_init     = &sched_init,
 	.on_cmd      = &sched_cmd,
-	.on_tick     = &sched_tick,
 	.on_quit     = &sched_quit,
 	.on_mod_msg  = &sched_mod_msg,
 	.commands    = DEFINE_CMDS (
@@ -57,7 +55,26 @@ static SchedEntry** sched_vals;
 static inso_gist*   gist;
 
 static SchedOffset* sched_offsets;
-static time_t       offset_expiry;
+static int          offset_timer; // recalculates the offsets when the week ends
+
+// gist loads and saves after init happen on run_async workers, one job at a time. The work takes inso_gist_lock and
+// the job's last done callback releases it, so a second job waiting on the lock can't hold up the done that would release it.
+#define SCHED_JOB_SAVE -1
+
+typedef struct {
+	int   cmd;        // on_cmd's cmd, or SCHED_JOB_SAVE to only save
+	char  chan[64];
+	char  name[64];
+	char* arg;
+	bool  locked;
+	int   load_ret;
+	inso_gist_file* files;
+	inso_gist_file* upload;
+} SchedJob;
+
+static SchedJob*  gist_job;    // the one that's running
+static SchedJob** gist_queue;  // waiting for it to finish
+static inso_gist_file* sched_unsaved; // built by sched_upload, taken by the running job to save
 
 enum { MON, TUE, WED, THU, FRI, SAT, SUN, DAYS_IN_WEEK };
 static const char* days[] = { "mon", "tue", "wed", "thu", "fri", "sat", "sun" };
@@ -102,6 +119,8 @@ static int sched_off_cmp(const void* a, const void* b){
 	return ((SchedOffset*)a)->offset - ((SchedOffset*)b)->offset;
 }
 
+static void sched_offsets_expired(int timer_id, void* arg);
+
 static void sched_offsets_update(void){
 	sb_free(sched_offsets);
 
@@ -144,14 +163,14 @@ static void sched_offsets_update(void){
 		}
 	}
 
-	offset_expiry = week_start + (7*24*60*60);
+	if(offset_timer) ctx->cancel_timer(offset_timer);
+	offset_timer = ctx->add_timer(((7*24*60*60) - now) * 1000, 0, &sched_offsets_expired, NULL);
+
 	qsort(sched_offsets, sb_count(sched_offsets), sizeof(SchedOffset), &sched_off_cmp);
 }
 
-static bool sched_reload(void){
-	inso_gist_file* files = NULL;
-	int ret = inso_gist_load(gist, &files);
-
+// ret and files are from inso_gist_load, the caller frees files.
+static bool sched_parse(int ret, inso_gist_file* files){
 	if(ret == INSO_GIST_304){
 		puts("mod_schedule: not modified.");
 		return true;
@@ -229,12 +248,32 @@ static bool sched_reload(void){
 	}
 
 	yajl_tree_free(root);
-	inso_gist_file_free(files);
 	sched_offsets_update();
 
 	return true;
 }
 
+// the first load is downloaded on a worker thread, so that it doesn't hold up startup
+static struct {
+	int ret;
+	inso_gist_file* files;
+} sched_init_load;
+
+static void sched_init_work(void* arg){
+	sched_init_load.ret = inso_gist_load(gist, &sched_init_load.files);
+}
+
+static void sched_init_done(void* arg){
+	bool ok = !ctx->cancelled() && sched_parse(sched_init_load.ret, sched_init_load.files);
+
+	inso_gist_file_free(sched_init_load.files);
+	sched_init_load.files = NULL;
+
+	if(!ctx->cancelled()){
+		ctx->init_done(ok);
+	}
+}
+
 static bool sched_init(const IRCCoreCtx* _ctx){
 	ctx = _ctx;
 
@@ -257,9 +296,14 @@ static bool sched_init(const IRCCoreCtx* _ctx){
 	}
 
 	gist = inso_gist_open(gist_id, gist_user, gist_token);
-	return sched_reload();
+
+	ctx->init_later();
+	ctx->run_async(&sched_init_work, &sched_init_done, NULL);
+
+	return true;
 }
 
+// the file is saved by the gist job that's running, or the next SCHED_JOB_SAVE one.
 static void sched_upload(void){
 	inso_gist_file* file = NULL;
 
@@ -302,11 +346,12 @@ static void sched_upload(void){
 	yajl_gen_free(json);
 
 #if 1
-	inso_gist_save(gist, "insobot stream schedule", file);
+	inso_gist_file_free(sched_unsaved);
+	sched_unsaved = file;
 #else
 	printf("schedule.json: [%s]\n", file->content);
-#endif
 	inso_gist_file_free(file);
+#endif
 
 	sched_offsets_update();
 }
@@ -889,39 +934,101 @@ static void sched_next(const char* chan){
 	}
 }
 
-static void sched_cmd(const char* chan, const char* name, const char* arg, int cmd){
-	switch(cmd){
-		case SCHED_ADD: {
-			if(inso_is_wlist(ctx, name)){
-				inso_gist_lock(gist);
-				sched_reload();
-				sched_add(chan, name, arg);
-				inso_gist_unlock(gist);
-			}
-		} break;
-		
-		case SCHED_DEL: {
-			if(inso_is_wlist(ctx, name)){
-				inso_gist_lock(gist);
-				sched_reload();
-				sched_del(chan, name, arg);
-				inso_gist_unlock(gist);
-			}
-		} break;
+static void sched_job_free(SchedJob* job){
+	if(job->locked){
+		inso_gist_unlock(gist);
+	}
+	inso_gist_file_free(job->files);
+	inso_gist_file_free(job->upload);
+	free(job->arg);
+	free(job);
+}
 
-		case SCHED_EDIT: {
-			if(inso_is_wlist(ctx, name)){
-				inso_gist_lock(gist);
-				sched_reload();
-				sched_edit(chan, name, arg);
-				inso_gist_unlock(gist);
-			}
-		} break;
+static void sched_gist_work(void* arg){
+	SchedJob* job = arg;
+
+	if(!job->locked){
+		inso_gist_lock(gist);
+		job->locked = true;
+	}
 
+	if(job->upload){
+		inso_gist_save(gist, "insobot stream schedule", job->upload);
+	} else if(job->cmd != SCHED_JOB_SAVE){
+		job->load_ret = inso_gist_load(gist, &job->files);
+	}
+}
+
+static void sched_job_start(SchedJob* job);
+
+static void sched_gist_done(void* arg){
+	SchedJob* job = arg;
+
+	// only the running job can be cancelled, and sched_quit left the gist open for it
+	if(ctx->cancelled()){
+		sched_job_free(job);
+		gist_job = NULL;
+		inso_gist_close(gist);
+		return;
+	}
+
+	if(!job->upload){
+		// changes that haven't been saved yet win over the gist
+		if(job->cmd != SCHED_JOB_SAVE && !sched_unsaved){
+			sched_parse(job->load_ret, job->files);
+		}
+
+		switch(job->cmd){
+			case SCHED_ADD:  sched_add (job->chan, job->name, job->arg); break;
+			case SCHED_DEL:  sched_del (job->chan, job->name, job->arg); break;
+			case SCHED_EDIT: sched_edit(job->chan, job->name, job->arg); break;
+			case SCHED_SHOW: sched_show(job->chan, job->name, job->arg); break;
+		}
+
+		if(sched_unsaved){
+			job->upload = sched_unsaved;
+			sched_unsaved = NULL;
+			ctx->run_async(&sched_gist_work, &sched_gist_done, job);
+			return;
+		}
+	}
+
+	sched_job_free(job);
+	gist_job = NULL;
+
+	if(sb_count(gist_queue)){
+		SchedJob* next = gist_queue[0];
+		sb_erase(gist_queue, 0);
+		sched_job_start(next);
+	}
+}
+
+static void sched_job_start(SchedJob* job){
+	if(gist_job){
+		sb_push(gist_queue, job);
+	} else {
+		gist_job = job;
+		ctx->run_async(&sched_gist_work, &sched_gist_done, job);
+	}
+}
+
+static SchedJob* sched_job_new(int cmd, const char* chan, const char* name, const char* arg){
+	SchedJob* job = calloc(1, sizeof(*job));
+	job->cmd = cmd;
+	job->arg = strdup(arg);
+	*stpncpy(job->chan, chan, sizeof(job->chan)-1) = 0;
+	*stpncpy(job->name, name, sizeof(job->name)-1) = 0;
+	return job;
+}
+
+static void sched_cmd(const char* chan, const char* name, const char* arg, int cmd){
+	switch(cmd){
+		case SCHED_ADD:
+		case SCHED_DEL:
+		case SCHED_EDIT:
 		case SCHED_SHOW: {
 			if(inso_is_wlist(ctx, name)){
-				sched_reload();
-				sched_show(chan, name, arg);
+				sched_job_start(sched_job_new(cmd, chan, name, arg));
 			}
 		} break;
 
@@ -935,16 +1042,30 @@ static void sched_cmd(const char* chan, const char* name, const char* arg, int c
 	}
 }
 
-static void sched_tick(time_t now){
-	if(now >= offset_expiry){
-		sched_offsets_update();
-	}
+static void sched_offsets_expired(int timer_id, void* arg){
+	offset_timer = 0;
+	sched_offsets_update();
 }
 
 static void sched_quit(void){
+	inso_gist_file_free(sched_init_load.files);
+	sched_init_load.files = NULL;
+
 	sched_free();
 	sb_free(sched_offsets);
-	inso_gist_close(gist);
+
+	for(SchedJob** j = gist_queue; j < sb_end(gist_queue); ++j){
+		sched_job_free(*j);
+	}
+	sb_free(gist_queue);
+
+	inso_gist_file_free(sched_unsaved);
+	sched_unsaved = NULL;
+
+	// a running job might hold the lock, it's closed once that job is cancelled instead.
+	if(!gist_job){
+		inso_gist_close(gist);
+	}
 }
 
 static void sched_mod_msg(const char* sender, const IRCModMsg* msg){
@@ -1059,6 +1180,7 @@ static void sched_mod_msg(const char* sender, const IRCModMsg* msg){
 
 	if(strcmp(msg->cmd, "sched_save") == 0){
 		sched_upload();
+		sched_job_start(sched_job_new(SCHED_JOB_SAVE, "", "", ""));
 		return;
 	}
 }
@@ -50,6 +50,45 @@ static void wlist_check_cb(intptr_t result, intptr_t arg){
     if(result) *(bool*)arg = true;
 }
 
+typedef struct {
+    char* chan;
+    char* name;
+} SearchReq;
+
+static void search_done(const IRCHTTPResult* res, void* arg)
+{
+    SearchReq* req = arg;
+
+    if (ctx->cancelled()) {
+        // the module is being unloaded, just free req
+    } else if (res->status == 303) {
+        char* redir = NULL;
+        curl_easy_getinfo(res->curl, CURLINFO_REDIRECT_URL, &redir);
+
+        if (redir) {
+            ctx->send_msg(req->chan, "%s: %s", req->name, redir);
+        }
+    } else if (res->status < 0) {
+        ctx->send_msg(req->chan, "%s: Couldn't connect to the search engine!", req->name);
+        fprintf(stderr, "Error getting search results: %s\n", curl_easy_strerror(-res->status));
+    } else {
+        regmatch_t urlmatch[2];
+
+        if (regexec(&ddg_result_regex, res->data, 2, urlmatch, 0) == 0 && urlmatch[1].rm_so != -1) {
+            char* result = strndupa(res->data + urlmatch[1].rm_so,
+                                    urlmatch[1].rm_eo - urlmatch[1].rm_so);
+            ctx->send_msg(req->chan, "%s: %s", req->name, result);
+        } else {
+            ctx->send_msg(req->chan,
+                          "%s: I wasn't sure how to find a result, blame ChronalDragon", req->name);
+        }
+    }
+
+    free(req->chan);
+    free(req->name);
+    free(req);
+}
+
 static void search_cmd(const char* chan, const char* name, const char* msg, int cmd)
 {
     bool can_use_bonus = false;
@@ -66,49 +105,16 @@ static void search_cmd(const char* chan, const char* name, const char* msg, int
     curl_easy_cleanup(tempcurl);
     if (urlres == -1) { return; }
 
-    char* data = NULL;
-    CURL* curl = inso_curl_init(ddg_url, &data);
-    int curl_ret = curl_easy_perform(curl);
-	long http_code = 0;
-	curl_easy_getinfo(curl, CURLINFO_RESPONSE_CODE, &http_code);
-
-    if (http_code == 303) {
-        char* redir = NULL;
-        curl_easy_getinfo(curl, CURLINFO_REDIRECT_URL, &redir);
-
-        ctx->send_msg(chan, "%s: %s", name, redir);
-        return;
-    }
-
-    curl_easy_cleanup(curl);
-
-    sb_push(data, 0);
+    SearchReq* req = malloc(sizeof(*req));
+    req->chan = strdup(chan);
+    req->name = strdup(name);
 
-    if(curl_ret != 0){
+    if (!ctx->http_request(ddg_url, NULL, &search_done, req)) {
         ctx->send_msg(chan, "%s: Couldn't connect to the search engine!", name);
-        fprintf(stderr, "Error getting search results: %s\n", curl_easy_strerror(curl_ret));
-        free(ddg_url);
-        sb_free(data);
-        return;
+        free(req->chan);
+        free(req->name);
+        free(req);
     }
 
-    regmatch_t urlmatch[2];
-
-    if(regexec(&ddg_result_regex, data, 2, urlmatch, 0) == 0){
-        if (urlmatch[1].rm_so != -1) {
-            char* result = strndupa(data + urlmatch[1].rm_so, 
-                                    urlmatch[1].rm_eo - urlmatch[1].rm_so);
-            ctx->send_msg(chan, "%s: %s", name, result);
-        }
-        else {
-            ctx->send_msg(chan, 
-                          "%s: I wasn't sure how to find a result, blame ChronalDragon", name);
-        }
-    } else {
-            ctx->send_msg(chan, 
-                          "%s: I wasn't sure how to find a result, blame ChronalDragon", name);
-    }
-    
     free(ddg_url);
-    sb_free(data);
 }
@@ -6,13 +6,15 @@
 #include <yajl/yajl_tree.h>
 #include <ctype.h>
 #include "inso_utils.h"
+#include "module_msgs.h"
 
 static bool twitch_init    (const IRCCoreCtx*);
 static void twitch_cmd     (const char*, const char*, const char*, int);
-static void twitch_tick    (time_t);
 static bool twitch_save    (FILE*);
 static void twitch_quit    (void);
 static void twitch_mod_msg (const char* sender, const IRCModMsg* msg);
+static void twitch_tracker_tick  (int, void*);
+static void twitch_follower_tick (int, void*);
 
 enum { FOLLOW_NOTIFY, UPTIME, TWITCH_VOD, TWITCH_TRACKER, TWITCH_TITLE };
 
@@ -21,7 +23,6 @@ const IRCModuleCtx irc_mod_ctx = {
 	.desc     = "Functionality specific to twitch.tv",
 	.on_init  = twitch_init,
 	.on_cmd   = &twitch_cmd,
-	.on_tick  = &twitch_tick,
 	.on_save  = &twitch_save,
 	.on_quit  = &twitch_quit,
 	.on_mod_msg = &twitch_mod_msg,
@@ -42,9 +43,7 @@ static const long tracker_update_interval = 60;
 
 static time_t last_uptime_check;
 static time_t last_follower_check;
-static time_t last_tracker_update;
 
-static CURL* curl;
 static struct curl_slist* twitch_headers;
 
 // TwitchInfo -> data for uptime, follow notifier, vod + tracker
@@ -65,7 +64,7 @@ typedef struct {
 	char* stream_title;
 } TwitchInfo;
 
-static char**      twitch_keys;
+static const char** twitch_keys; // interned with ctx->intern
 static TwitchInfo* twitch_vals;
 
 // TwitchTag -> holds which channels a person wants to get pinged about in the tracker
@@ -79,15 +78,18 @@ static char**      twitch_tracker_chans;
 static TwitchTag*  twitch_tracker_tags;
 
 static bool        first_update = true;
+static bool        tracker_pending;  // waiting on the streams request from twitch_tracker_tick
+static bool        follower_pending; // same for twitch_follower_tick
 
 // TwitchUser -> cache for twitch_get_user_date mod_msg
 
 typedef struct {
-	char* name;
+	const char* name; // interned with ctx->intern
 	time_t created_at;
 } TwitchUser;
 
 static TwitchUser* twitch_users;
+static char**      twitch_users_pending; // names being looked up by twitch_fetch_user, owned by its requests
 
 static TwitchInfo* twitch_get_or_add(const char* chan){
 
@@ -98,15 +100,17 @@ static TwitchInfo* twitch_get_or_add(const char* chan){
 		chan = new_chan;
 	}
 
-	for(char** c = twitch_keys; c < sb_end(twitch_keys); ++c){
-		if(strcmp(*c, chan) == 0){
+	chan = ctx->intern(chan);
+
+	for(const char** c = twitch_keys; c < sb_end(twitch_keys); ++c){
+		if(*c == chan){
 			return twitch_vals + (c - twitch_keys);
 		}
 	}
 
 	TwitchInfo ti = {};
 
-	sb_push(twitch_keys, strdup(chan));
+	sb_push(twitch_keys, chan);
 	sb_push(twitch_vals, ti);
 
 	return twitch_vals + sb_count(twitch_vals) - 1;
@@ -118,7 +122,6 @@ static bool twitch_init(const IRCCoreCtx* _ctx){
 	time_t now = time(0);
 	last_uptime_check = now;
 	last_follower_check = now;
-	last_tracker_update = now - 50;
 
 	FILE* f = fopen(ctx->get_datafile(), "r");
 
@@ -151,8 +154,6 @@ static bool twitch_init(const IRCCoreCtx* _ctx){
 	}
 	fclose(f);
 
-	curl = curl_easy_init();
-
 	const char* client_id = getenv("INSOBOT_TWITCH_CLIENT_ID");
 	if(client_id){
 		char buf[256];
@@ -167,11 +168,15 @@ static bool twitch_init(const IRCCoreCtx* _ctx){
 		twitch_headers = curl_slist_append(twitch_headers, buf);
 	}
 
+	ctx->add_timer(10 * 1000, tracker_update_interval * 1000, &twitch_tracker_tick, NULL);
+	ctx->add_timer(follower_check_interval * 1000, follower_check_interval * 1000, &twitch_follower_tick, NULL);
+
 	return true;
 }
 
-static long __attribute__((format(printf, 3, 4)))
-twitch_curl(char** data, long last_time, const char* fmt, ...){
+// cb is called with the result once it arrives. res->status is -CURLcode on error.
+static bool __attribute__((format(printf, 4, 5)))
+twitch_request(long last_time, void (*cb)(const IRCHTTPResult* res, void* arg), void* arg, const char* fmt, ...){
 	va_list v;
 	va_start(v, fmt);
 
@@ -183,67 +188,41 @@ twitch_curl(char** data, long last_time, const char* fmt, ...){
 
 	va_end(v);
 
-	*data = NULL;
-	inso_curl_reset(curl, url, data);
+	// the core takes this over, and replaces the write callback with its own
+	CURL* req = inso_curl_init(url, NULL);
+	free(url);
 
 	if(twitch_headers){
-		curl_easy_setopt(curl, CURLOPT_HTTPHEADER, twitch_headers);
+		curl_easy_setopt(req, CURLOPT_HTTPHEADER, twitch_headers);
 	}
 
 	if(last_time){
-		curl_easy_setopt(curl, CURLOPT_TIMECONDITION, CURL_TIMECOND_IFMODSINCE);
-		curl_easy_setopt(curl, CURLOPT_TIMEVALUE, last_time);
-	}
-
-	//curl_easy_setopt(curl, CURLOPT_HEADERFUNCTION, fwrite);
-	//curl_easy_setopt(curl, CURLOPT_HEADERDATA, stderr);
-
-	CURLcode ret = curl_easy_perform(curl);
-	free(url);
-
-	if(ret != 0){
-		fprintf(stderr, "twitch_curl: error: %s\n", curl_easy_strerror(ret));
-		sb_free(*data);
-		return -1;
+		curl_easy_setopt(req, CURLOPT_TIMECONDITION, CURL_TIMECOND_IFMODSINCE);
+		curl_easy_setopt(req, CURLOPT_TIMEVALUE, last_time);
 	}
 
-	long http_code = 0;
-	curl_easy_getinfo(curl, CURLINFO_RESPONSE_CODE, &http_code);
-
-	if(http_code == 304){
-		sb_free(*data);
-	} else {
-		sb_push(*data, 0);
-	}
-
-	return http_code;
+	IRCHTTPOpts opts = { .curl = req };
+	return ctx->http_request(NULL, &opts, cb, arg);
 }
 
-static void twitch_check_uptime(size_t count, size_t* indices){
-	if(count == 0) return;
-
-	char chan_buffer[1024] = {};
+static void twitch_uptime_chans(char* buf, size_t buf_sz, size_t count, const size_t* indices){
+	*buf = 0;
 	for(size_t i = 0; i < count; ++i){
-		inso_strcat(chan_buffer, sizeof(chan_buffer), twitch_keys[indices[i]] + 1);
-		inso_strcat(chan_buffer, sizeof(chan_buffer), ",");
+		inso_strcat(buf, buf_sz, twitch_keys[indices[i]] + 1);
+		inso_strcat(buf, buf_sz, ",");
 	}
+}
 
-	char* data = NULL;
+// applies the response of a streams request for the channels at indices. ret is negative on error.
+static void twitch_uptime_update(long ret, char* data, size_t count, const size_t* indices, time_t now){
 	yajl_val root = NULL;
-	time_t now = time(0);
-
-	//printf("chan buf: [%s]\n", chan_buffer);
-	//printf("last_time: %zu\n", last_uptime_check);
-
-	long ret = twitch_curl(&data, last_uptime_check, "https://api.twitch.tv/kraken/streams?channel=%s", chan_buffer);
-	last_uptime_check = now;
 
 	if(ret == 304){
 		puts("304");
 		goto unchanged;
 	}
 
-	if(ret == -1 || !(root = yajl_tree_parse(data, NULL, 0))){
+	if(ret < 0 || !(root = yajl_tree_parse(data, NULL, 0))){
 		fprintf(stderr, "mod_twitch: error getting uptime.\n");
 		goto unchanged;
 	}
@@ -296,7 +275,6 @@ static void twitch_check_uptime(size_t count, size_t* indices){
 	}
 
 	yajl_tree_free(root);
-	sb_free(data);
 	return;
 
 unchanged:
@@ -305,36 +283,103 @@ unchanged:
 	}
 }
 
+typedef struct {
+	size_t* indices;
+	time_t  now;
+	void  (*then)(void* arg);
+	void*   then_arg;
+} TwitchUptimeReq;
+
+static void twitch_check_uptime_done(const IRCHTTPResult* res, void* arg){
+	TwitchUptimeReq* req = arg;
+
+	if(!ctx->cancelled()){
+		twitch_uptime_update(res->status, res->data, sb_count(req->indices), req->indices, req->now);
+		if(req->then) req->then(req->then_arg);
+	}
+
+	sb_free(req->indices);
+	free(req->then_arg);
+	free(req);
+}
+
+// Takes over indices, and calls then (if set) once the uptimes are updated. then_arg is malloc'd or NULL, and freed afterwards.
+static void twitch_check_uptime_async(size_t* indices, void (*then)(void* arg), void* then_arg){
+	if(!sb_count(indices)){
+		if(then) then(then_arg);
+		free(then_arg);
+		return;
+	}
+
+	char chan_buffer[1024];
+	twitch_uptime_chans(chan_buffer, sizeof(chan_buffer), sb_count(indices), indices);
+
+	TwitchUptimeReq* req = malloc(sizeof(*req));
+	req->indices = indices;
+	req->now     = time(0);
+	req->then     = then;
+	req->then_arg = then_arg;
+
+	bool ok = twitch_request(last_uptime_check, &twitch_check_uptime_done, req, "https://api.twitch.tv/kraken/streams?channel=%s", chan_buffer);
+	last_uptime_check = req->now;
+
+	// carry on as if it was a failed request
+	if(!ok){
+		twitch_uptime_update(-1, NULL, sb_count(indices), indices, req->now);
+		if(then) then(then_arg);
+		sb_free(indices);
+		free(then_arg);
+		free(req);
+	}
+}
+
+// answers from what's known already, a stale channel is refreshed in the background for next time.
 static bool twitch_check_live(size_t index){
 	time_t now = time(0);
 
 	TwitchInfo* t = twitch_vals + index;
 
 	if(now - t->last_uptime_check > uptime_check_interval){
-		twitch_check_uptime(1, (size_t[]){ index });
 		t->last_uptime_check = now;
+
+		size_t* indices = NULL;
+		sb_push(indices, index);
+		twitch_check_uptime_async(indices, NULL, NULL);
 	}
 
 	return t->stream_start != 0;
 }
 
 static const char* twitch_display_name(const char* fallback){
-	int i = 0;
-	const char *k, *v;
 	static char caps_buffer[256];
+	const char* v = ctx->get_tag_by_name("display-name");
 
-	while(ctx->get_tag(i++, &k, &v)){
-		if(strcmp(k, "display-name") == 0){
-			if(*v) return v;
-			else { // When twitch returns an empty tag, the web UI shows the first char capitalized.
-				strncpy(caps_buffer, fallback, 255);
-				caps_buffer[0] = toupper(caps_buffer[0]);
-				return caps_buffer;
-			}
-		}
+	if(!v) return fallback;
+
+	if(*v) return v;
+	else { // When twitch returns an empty tag, the web UI shows the first char capitalized.
+		strncpy(caps_buffer, fallback, 255);
+		caps_buffer[0] = toupper(caps_buffer[0]);
+		return caps_buffer;
 	}
+}
 
-	return fallback;
+// who to answer once a command's request to twitch is done. The display name is only available while the command runs.
+typedef struct {
+	size_t index;
+	char   chan[64];
+	char   name[64];
+	char   dispname[128];
+	bool   check_alias;
+} TwitchReply;
+
+static TwitchReply* twitch_reply_new(size_t index, const char* chan, const char* name){
+	TwitchReply* r = calloc(1, sizeof(*r));
+	r->index = index;
+	*stpncpy(r->chan    , chan                     , sizeof(r->chan)-1    ) = 0;
+	*stpncpy(r->name    , name                     , sizeof(r->name)-1    ) = 0;
+	*stpncpy(r->dispname, twitch_display_name(name), sizeof(r->dispname)-1) = 0;
+	return r;
 }
 
 static intptr_t check_alias_cb(intptr_t result, intptr_t arg){
@@ -342,23 +387,24 @@ static intptr_t check_alias_cb(intptr_t result, intptr_t arg){
 	return 0;
 }
 
-static void twitch_print_vod(size_t index, const char* send_chan, const char* name, bool check_alias){
+static void twitch_print_vod_done(const IRCHTTPResult* res, void* arg){
+	TwitchReply* r = arg;
+	yajl_val root = NULL;
 
-	char* chan    = twitch_keys[index];
-	TwitchInfo* t = twitch_vals + index;
+	if(ctx->cancelled()) goto out;
 
-	char* data = NULL;
-	const char url_fmt[] = "https://api.twitch.tv/kraken/channels/%s/videos?broadcasts=true&limit=1";
+	const char* chan = twitch_keys[r->index];
+	const char* send_chan = r->chan;
+	TwitchInfo* t = twitch_vals + r->index;
 
-	long ret = twitch_curl(&data, t->last_vod_check, url_fmt, chan + 1);
-	if(ret == 304 || ret == -1){
+	if(res->status == 304 || res->status < 0){
 		if(t->last_vod_msg){
-			ctx->send_msg(send_chan, "%s: %s", name, t->last_vod_msg);
+			ctx->send_msg(send_chan, "%s: %s", r->name, t->last_vod_msg);
 		}
-		return;
+		goto out;
 	}
 
-	yajl_val root = yajl_tree_parse(data, NULL, 0);
+	root = yajl_tree_parse(res->data, NULL, 0);
 	if(!root){
 		fprintf(stderr, "twitch_print_vod: root null\n");
 		goto out;
@@ -377,13 +423,13 @@ static void twitch_print_vod(size_t index, const char* send_chan, const char* na
 	if(videos->u.array.len == 0){
 		int alias_exists = 0;
 
-		if(check_alias){
+		if(r->check_alias){
 			const char* args[] = { "vod", send_chan };
 			MOD_MSG(ctx, "alias_exists", args, &check_alias_cb, &alias_exists);
 		}
 
 		if(!alias_exists){
-			ctx->send_msg(send_chan, "%s: No recent VoD found for %s.", name, chan + 1);
+			ctx->send_msg(send_chan, "%s: No recent VoD found for %s.", r->name, chan + 1);
 		}
 
 		goto out;
@@ -404,14 +450,24 @@ static void twitch_print_vod(size_t index, const char* send_chan, const char* na
 	}
 
 	const char* title = vod_title->u.string ?: "untitled";
-	const char* dispname = twitch_display_name(name);
 
 	asprintf_check(&t->last_vod_msg, "%s's last VoD: %s [%s]", chan + 1, vod_url->u.string, title);
-	ctx->send_msg(send_chan, "%s: %s", dispname, t->last_vod_msg);
+	ctx->send_msg(send_chan, "%s: %s", r->dispname, t->last_vod_msg);
 
 out:
-	if(data) sb_free(data);
 	if(root) yajl_tree_free(root);
+	free(r);
+}
+
+static void twitch_print_vod(size_t index, const char* send_chan, const char* name, bool check_alias){
+	TwitchReply* r = twitch_reply_new(index, send_chan, name);
+	r->check_alias = check_alias;
+
+	const char url_fmt[] = "https://api.twitch.tv/kraken/channels/%s/videos?broadcasts=true&limit=1";
+
+	if(!twitch_request(twitch_vals[index].last_vod_check, &twitch_print_vod_done, r, url_fmt, twitch_keys[index] + 1)){
+		free(r);
+	}
 }
 
 #define TWITCH_TRACKER_MSG(fmt, ...) \
@@ -450,7 +506,9 @@ static void twitch_print_tags(const char* prefix, const char* stream){
 	}
 }
 
-static void twitch_tracker_update(void){
+// called once the tracked channels' uptimes have been updated by twitch_tracker_tick
+static void twitch_tracker_update(void* arg){
+	tracker_pending = false;
 
 	char topic[1024] = "\002\0030,4[LIVE]\017 ";
 
@@ -458,19 +516,6 @@ static void twitch_tracker_update(void){
 	bool any_live = false;
 	bool sent_ping = false;
 
-	size_t* track_indices = NULL;
-	size_t index_count = 0;
-
-	for(size_t i = 0; i < sb_count(twitch_keys); ++i){
-		if(twitch_vals[i].is_tracked){
-			sb_push(track_indices, i);
-			index_count++;
-		}
-	}
-
-	twitch_check_uptime(index_count, track_indices);
-	sb_free(track_indices);
-
 	// don't output on the first update, to avoid duplication in case the bot has been restarted.
 	if(first_update){
 		first_update = false;
@@ -649,8 +694,8 @@ static void twitch_tracker_cmd(const char* chan, const char* name, const char* a
 
 				for(TwitchInfo* t = twitch_vals; t < sb_end(twitch_vals); ++t){
 					if(!t->is_tracked || !t->stream_start) continue;
-					char* channel_name = twitch_keys[t - twitch_vals];
-					char* display_name = t->tracked_name ? t->tracked_name : channel_name + 1;
+					const char* channel_name = twitch_keys[t - twitch_vals];
+					const char* display_name = t->tracked_name ? t->tracked_name : channel_name + 1;
 
 					ctx->send_msg(
 						chan,
@@ -680,62 +725,103 @@ static void twitch_tracker_cmd(const char* chan, const char* name, const char* a
 	}
 }
 
-static void twitch_get_title(const char* chan, const char* name){
-	char* data = NULL;
+static void twitch_get_title_done(const IRCHTTPResult* res, void* arg){
+	TwitchReply* r = arg;
 	static const char* status_path[] = { "status", NULL };
 
-	if(twitch_curl(&data, 0, "https://api.twitch.tv/kraken/channels/%s", chan+1) == 200){
-		yajl_val root   = yajl_tree_parse(data, NULL, 0);
+	if(!ctx->cancelled() && res->status == 200){
+		yajl_val root   = yajl_tree_parse(res->data, NULL, 0);
 		yajl_val status = yajl_tree_get(root, status_path, yajl_t_string);
 
 		if(status){
-			ctx->send_msg(chan, "%s: Current title for %s: [%s].", inso_dispname(ctx, name), chan, status->u.string);
+			ctx->send_msg(r->chan, "%s: Current title for %s: [%s].", r->dispname, r->chan, status->u.string);
 		}
 
 		yajl_tree_free(root);
 	}
 
-	sb_free(data);
+	free(r);
+}
+
+static void twitch_get_title(const char* chan, const char* name){
+	TwitchReply* r = twitch_reply_new(0, chan, name);
+
+	if(!twitch_request(0, &twitch_get_title_done, r, "https://api.twitch.tv/kraken/channels/%s", chan+1)){
+		free(r);
+	}
+}
+
+static void twitch_set_title_done(const IRCHTTPResult* res, void* arg){
+	TwitchReply* r = arg;
+
+	if(ctx->cancelled()){
+		free(r);
+		return;
+	}
+
+	// status is the curl error for a failed request, but the http code is still wanted here
+	long http_code = 0;
+	curl_easy_getinfo(res->curl, CURLINFO_RESPONSE_CODE, &http_code);
+
+	if(http_code == 200){
+		ctx->send_msg(r->chan, "%s: Title updated successfully.", r->dispname);
+	} else if(http_code == 403){
+		ctx->send_msg(r->chan, "%s: I don't have permission to update the title.", r->dispname);
+	} else {
+		ctx->send_msg(r->chan, "%s: Error updating title for channel \"%s\".", r->dispname, r->chan+1);
+		fprintf(stderr, "response: [%s]\n", res->data);
+	}
+
+	free(r);
 }
 
 static void twitch_set_title(const char* chan, const char* name, const char* msg){
+	char* url;
+	asprintf_check(&url, "https://api.twitch.tv/kraken/channels/%s", chan+1);
 
-	char* title = curl_easy_escape(curl, msg, 0);
+	// the core takes this over, like in twitch_request
+	CURL* req = inso_curl_init(url, NULL);
+	free(url);
 
-	char *url, *data;
-	asprintf_check(&url , "https://api.twitch.tv/kraken/channels/%s", chan+1);
+	char* title = curl_easy_escape(req, msg, 0);
+	char* data;
 	asprintf_check(&data, "channel[status]=%s", title);
-
 	curl_free(title);
 
-	char* response = NULL;
-	inso_curl_reset(curl, url, &response);
+	curl_easy_setopt(req, CURLOPT_HTTPHEADER, twitch_headers);
+	curl_easy_setopt(req, CURLOPT_CUSTOMREQUEST, "PUT");
 
-	curl_easy_setopt(curl, CURLOPT_POST, 1);
-	curl_easy_setopt(curl, CURLOPT_POSTFIELDS, data);
-	curl_easy_setopt(curl, CURLOPT_HTTPHEADER, twitch_headers);
-	curl_easy_setopt(curl, CURLOPT_CUSTOMREQUEST, "PUT");
+	TwitchReply* r = twitch_reply_new(0, chan, name);
+	IRCHTTPOpts opts = { .curl = req, .post_data = data };
 
-	curl_easy_perform(curl);
+	if(!ctx->http_request(NULL, &opts, &twitch_set_title_done, r)){
+		free(r);
+	}
 
-	free(url);
 	free(data);
+}
 
-	long http_code = 0;
-	curl_easy_getinfo(curl, CURLINFO_RESPONSE_CODE, &http_code);
+static void twitch_print_uptime(void* arg){
+	TwitchReply* r = arg;
+	TwitchInfo* t = twitch_vals + r->index;
 
-	const char* dispname = twitch_display_name(name);
+	if(t->stream_start){
+		int minutes = (time(0) - t->stream_start) / 60;
+		char time_buf[256];
+		char *time_ptr = time_buf;
+		size_t time_sz = sizeof(time_buf);
 
-	if(http_code == 200){
-		ctx->send_msg(chan, "%s: Title updated successfully.", dispname);
-	} else if(http_code == 403){
-		ctx->send_msg(chan, "%s: I don't have permission to update the title.", dispname);
+		if(minutes > 60){
+			int h = minutes / 60;
+			snprintf_chain(&time_ptr, &time_sz, "%d hour%s, ", h, h == 1 ? "" : "s");
+			minutes %= 60;
+		}
+		snprintf_chain(&time_ptr, &time_sz, "%d minute%s.", minutes, minutes == 1 ? "" : "s");
+
+		ctx->send_msg(r->chan, "%s: The stream has been live for %s", r->dispname, time_buf);
 	} else {
-		ctx->send_msg(chan, "%s: Error updating title for channel \"%s\".", dispname, chan+1);
-		fprintf(stderr, "response: [%s]\n", response);
+		ctx->send_msg(r->chan, "%s: The stream is not live.", r->dispname);
 	}
-
-	sb_free(response);
 }
 
 static void twitch_cmd(const char* chan, const char* name, const char* arg, int cmd){
@@ -779,26 +865,16 @@ static void twitch_cmd(const char* chan, const char* name, const char* arg, int
 				*stpncpy(c, chan, sizeof(chan_buf)-1) = 0;
 			}
 
-			time_t now = time(0);
-
 			TwitchInfo* t = twitch_get_or_add(c);
+			TwitchReply* r = twitch_reply_new(t - twitch_vals, chan, name);
 
-			if(twitch_check_live(t - twitch_vals)){
-				int minutes = (now - t->stream_start) / 60;
-				char time_buf[256];
-				char *time_ptr = time_buf;
-				size_t time_sz = sizeof(time_buf);
-
-				if(minutes > 60){
-					int h = minutes / 60;
-					snprintf_chain(&time_ptr, &time_sz, "%d hour%s, ", h, h == 1 ? "" : "s");
-					minutes %= 60;
-				}
-				snprintf_chain(&time_ptr, &time_sz, "%d minute%s.", minutes, minutes == 1 ? "" : "s");
-
-				ctx->send_msg(chan, "%s: The stream has been live for %s", dispname, time_buf);
+			if(time(0) - t->last_uptime_check > uptime_check_interval){
+				size_t* indices = NULL;
+				sb_push(indices, r->index);
+				twitch_check_uptime_async(indices, &twitch_print_uptime, r);
 			} else {
-				ctx->send_msg(chan, "%s: The stream is not live.", dispname);
+				twitch_print_uptime(r);
+				free(r);
 			}
 		} break;
 
@@ -845,118 +921,135 @@ static const char* follows_path[] = { "follows", NULL };
 static const char* date_path[] = { "created_at", NULL };
 static const char* name_path[] = { "user", "display_name", NULL };
 
-static void twitch_check_followers(void){
+static void twitch_followers_done(const IRCHTTPResult* res, void* arg){
+	const size_t index = (uintptr_t)arg;
+	const char* chan = twitch_keys[index];
+	TwitchInfo* t = twitch_vals + index;
 
-	char* data = NULL;
-	yajl_val root = NULL;
+	if(res->status == 304 || res->status < 0){
+		return;
+	}
 
-	for(size_t i = 0; i < sb_count(twitch_keys); ++i){
+	yajl_val root = yajl_tree_parse(res->data, NULL, 0);
 
-		char* chan    = twitch_keys[i];
-		TwitchInfo* t = twitch_vals + i;
+	if(!YAJL_IS_OBJECT(root)){
+		fprintf(stderr, "mod_twitch: root not object!\n");
+		goto out;
+	}
 
-		if(!t->do_follower_notify || !twitch_check_live(i)){
-			continue;
-		}
+	yajl_val follows = yajl_tree_get(root, follows_path, yajl_t_array);
+	if(!follows){
+		fprintf(stderr, "mod_twitch: follows not array!\n");
+		goto out;
+	}
 
-		long ret = twitch_curl(&data, last_follower_check, twitch_api_template, chan + 1);
-		if(ret == 304){
-			continue;
-		} else if(ret == -1){
-			goto out;
-		}
+	char msg_buf[256] = {};
+	size_t new_follow_count = 0;
+	time_t new_time = t->last_follower_time;
 
-		root = yajl_tree_parse(data, NULL, 0);
+	for(size_t j = 0; j < follows->u.array.len; ++j){
+		yajl_val user = follows->u.array.values[j];
 
-		if(!YAJL_IS_OBJECT(root)){
-			fprintf(stderr, "mod_twitch: root not object!\n");
+		yajl_val date = yajl_tree_get(user, date_path, yajl_t_string);
+		if(!date){
+			fprintf(stderr, "mod_twitch date object null!\n");
 			goto out;
 		}
 
-		yajl_val follows = yajl_tree_get(root, follows_path, yajl_t_array);
-		if(!follows){
-			fprintf(stderr, "mod_twitch: follows not array!\n");
+		yajl_val name = yajl_tree_get(user, name_path, yajl_t_string);
+		if(!name){
+			fprintf(stderr, "mod_twitch name object null!\n");
 			goto out;
 		}
 
-		char msg_buf[256] = {};
-		size_t new_follow_count = 0;
-		time_t new_time = t->last_follower_time;
+		struct tm follow_tm = {};
+		char* end = strptime(date->u.string, "%Y-%m-%dT%TZ", &follow_tm);
+		if(!end || *end){
+			fprintf(stderr, "mod_twitch wrong date format?!\n");
+			goto out;
+		}
 
-		for(size_t j = 0; j < follows->u.array.len; ++j){
-			yajl_val user = follows->u.array.values[j];
+		time_t follow_time = mktime(&follow_tm);
 
-			yajl_val date = yajl_tree_get(user, date_path, yajl_t_string);
-			if(!date){
-				fprintf(stderr, "mod_twitch date object null!\n");
-				goto out;
+		if(follow_time > t->last_follower_time){
+			++new_follow_count;
+			if(j){
+				inso_strcat(msg_buf, sizeof(msg_buf), ", ");
 			}
+			inso_strcat(msg_buf, sizeof(msg_buf), name->u.string);
 
-			yajl_val name = yajl_tree_get(user, name_path, yajl_t_string);
-			if(!name){
-				fprintf(stderr, "mod_twitch name object null!\n");
-				goto out;
-			}
+			if(follow_time > new_time) new_time = follow_time;
+		}
+	}
 
-			struct tm follow_tm = {};
-			char* end = strptime(date->u.string, "%Y-%m-%dT%TZ", &follow_tm);
-			if(!end || *end){
-				fprintf(stderr, "mod_twitch wrong date format?!\n");
-				goto out;
-			}
+	t->last_follower_time = new_time;
 
-			time_t follow_time = mktime(&follow_tm);
+	if(new_follow_count == 1){
+		ctx->send_msg(chan, "Thank you to %s for following the channel! <3", msg_buf);
+	} else if(new_follow_count > 1){
+		ctx->send_msg(chan, "Thank you new followers: %s! <3", msg_buf);
+	}
 
-			if(follow_time > t->last_follower_time){
-				++new_follow_count;
-				if(j){
-					inso_strcat(msg_buf, sizeof(msg_buf), ", ");
-				}
-				inso_strcat(msg_buf, sizeof(msg_buf), name->u.string);
+out:
+	if(root) yajl_tree_free(root);
+}
 
-				if(follow_time > new_time) new_time = follow_time;
-			}
-		}
+// called once twitch_follower_tick has the uptimes, to check the live channels for new followers
+static void twitch_check_followers(void* arg){
+	follower_pending = false;
 
-		t->last_follower_time = new_time;
+	for(size_t i = 0; i < sb_count(twitch_keys); ++i){
+		const char* chan = twitch_keys[i];
+		TwitchInfo* t = twitch_vals + i;
 
-		if(new_follow_count == 1){
-			ctx->send_msg(chan, "Thank you to %s for following the channel! <3", msg_buf);
-		} else if(new_follow_count > 1){
-			ctx->send_msg(chan, "Thank you new followers: %s! <3", msg_buf);
+		if(!t->do_follower_notify || !t->stream_start){
+			continue;
 		}
 
-		sb_free(data);
-		data = NULL;
-
-		yajl_tree_free(root);
-		root = NULL;
+		twitch_request(last_follower_check, &twitch_followers_done, (void*)(uintptr_t)i, twitch_api_template, chan + 1);
 	}
 
-out:
-	if(data) sb_free(data);
-	if(root) yajl_tree_free(root);
+	last_follower_check = time(0);
 }
 
-static void twitch_tick(time_t now){
+static void twitch_tracker_tick(int timer_id, void* arg){
+	// a slow response shouldn't overlap with the next update
+	if(tracker_pending) return;
 
-	if(now - last_tracker_update > tracker_update_interval){
-//		puts("mod_twitch: tracker update...");
-		twitch_tracker_update();
-		last_tracker_update = now;
+//	puts("mod_twitch: tracker update...");
+	size_t* track_indices = NULL;
+
+	for(size_t i = 0; i < sb_count(twitch_keys); ++i){
+		if(twitch_vals[i].is_tracked){
+			sb_push(track_indices, i);
+		}
 	}
 
-	if(sb_count(twitch_keys) && (now - last_follower_check > follower_check_interval)){
-//		puts("mod_twitch: checking new followers...");
-		twitch_check_followers();
-		last_follower_check = now;
+	tracker_pending = true;
+	twitch_check_uptime_async(track_indices, &twitch_tracker_update, NULL);
+}
+
+static void twitch_follower_tick(int timer_id, void* arg){
+	if(!sb_count(twitch_keys) || follower_pending) return;
+
+	// same as twitch_check_live, but for all the channels at once
+	size_t* stale_indices = NULL;
+	time_t now = time(0);
+
+	for(size_t i = 0; i < sb_count(twitch_keys); ++i){
+		if(twitch_vals[i].do_follower_notify && now - twitch_vals[i].last_uptime_check > uptime_check_interval){
+			sb_push(stale_indices, i);
+		}
 	}
 
+//	puts("mod_twitch: checking new followers...");
+	follower_pending = true;
+	twitch_check_uptime_async(stale_indices, &twitch_check_followers, NULL);
 }
 
 static bool twitch_save(FILE* f){
 	for(TwitchInfo* t = twitch_vals; t < sb_end(twitch_vals); ++t){
-		char* key = twitch_keys[t - twitch_vals];
+		const char* key = twitch_keys[t - twitch_vals];
 		if(t->do_follower_notify){
 			fprintf(f, "NOTIFY\t%s\n", key);
 		}
@@ -982,7 +1075,6 @@ static bool twitch_save(FILE* f){
 
 static void twitch_quit(void){
 	for(size_t i = 0; i < sb_count(twitch_keys); ++i){
-		free(twitch_keys[i]);
 		free(twitch_vals[i].last_vod_msg);
 		free(twitch_vals[i].stream_title);
 		free(twitch_vals[i].tracked_name);
@@ -999,46 +1091,78 @@ static void twitch_quit(void){
 	}
 	sb_free(twitch_tracker_tags);
 
-	for(TwitchUser* u = twitch_users; u < sb_end(twitch_users); ++u) free(u->name);
 	sb_free(twitch_users);
+	sb_free(twitch_users_pending);
 
 	if(twitch_headers){
 		curl_slist_free_all(twitch_headers);
 	}
-
-	curl_easy_cleanup(curl);
 }
 
 static TwitchUser* twitch_get_user(const char* name){
-
 	for(size_t i = 0; i < sb_count(twitch_users); ++i){
-		if(strcasecmp(name, twitch_users[i].name) == 0){
+		if(strcasecmp(twitch_users[i].name, name) == 0){
 			return twitch_users + i;
 		}
 	}
+	return NULL;
+}
 
-	char* data = NULL;
-	if(twitch_curl(&data, 0, "https://api.twitch.tv/kraken/users/%s", name) != 200) return NULL;
+static void twitch_fetch_user_done(const IRCHTTPResult* res, void* arg){
+	char* name = arg;
+	yajl_val root = NULL;
 
-	yajl_val root = yajl_tree_parse(data, NULL, 0);
-	if(!root) return NULL;
+	if(ctx->cancelled()) goto out;
+
+	for(size_t i = 0; i < sb_count(twitch_users_pending); ++i){
+		if(twitch_users_pending[i] == name){
+			sb_erase(twitch_users_pending, i);
+			break;
+		}
+	}
+
+	if(res->status != 200) goto out;
+
+	root = yajl_tree_parse(res->data, NULL, 0);
+	if(!root) goto out;
 
 	const char* created_path[] = { "created_at", NULL };
 	yajl_val created = yajl_tree_get(root, created_path, yajl_t_string);
-	if(!created) return NULL;
+	if(!created) goto out;
 
 	struct tm user_time = {};
 	char* end = strptime(created->u.string, "%Y-%m-%dT%TZ", &user_time);
-	if(!end || *end) return NULL;
+	if(!end || *end) goto out;
 
+	// only interned once it's known to be a real user, so failed lookups don't keep their names around
 	TwitchUser u = {
-		.name = strdup(name),
+		.name = ctx->intern(name),
 		.created_at = timegm(&user_time)
 	};
 
 	sb_push(twitch_users, u);
 
-	return &sb_last(twitch_users);
+	TwitchUserDate msg = { .name = u.name, .created_at = u.created_at };
+	MOD_MSG(ctx, "twitch_user_date", &msg, NULL, 0);
+
+out:
+	if(root) yajl_tree_free(root);
+	free(name);
+}
+
+// looks the user up in the background, unless that's already happening. The answer is sent out as "twitch_user_date".
+static void twitch_fetch_user(const char* name){
+	for(char** n = twitch_users_pending; n < sb_end(twitch_users_pending); ++n){
+		if(strcasecmp(*n, name) == 0) return;
+	}
+
+	char* arg = strdup(name);
+
+	if(twitch_request(0, &twitch_fetch_user_done, arg, "https://api.twitch.tv/kraken/users/%s", name)){
+		sb_push(twitch_users_pending, arg);
+	} else {
+		free(arg);
+	}
 }
 
 static void twitch_mod_msg(const char* sender, const IRCModMsg* msg){
@@ -1046,6 +1170,8 @@ static void twitch_mod_msg(const char* sender, const IRCModMsg* msg){
 		TwitchUser* u = twitch_get_user((char*)msg->arg);
 		if(u){
 			msg->callback(u->created_at, msg->cb_arg);
+		} else {
+			twitch_fetch_user((char*)msg->arg);
 		}
 	} else if(strcmp(msg->cmd, "twitch_is_live") == 0){
 		const char* prev_p = (const char*)msg->arg;
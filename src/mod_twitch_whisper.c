@@ -7,7 +7,7 @@
 static bool whisper_init    (const IRCCoreCtx*);
 static void whisper_filter  (size_t, const char*, char*, size_t);
 static void whisper_connect (const char*);
-static void whisper_unknown (const char*, const char*, const char**, size_t);
+static void whisper_twitch  (const IRCTwitchEvent*);
 
 const IRCModuleCtx irc_mod_ctx = {
 	.name       = "whisper",
@@ -17,7 +17,7 @@ const IRCModuleCtx irc_mod_ctx = {
 	.on_init    = &whisper_init,
 	.on_filter  = &whisper_filter,
 	.on_connect = &whisper_connect,
-	.on_unknown = &whisper_unknown,
+	.on_twitch  = &whisper_twitch,
 };
 
 static const IRCCoreCtx* ctx;
@@ -46,8 +46,8 @@ static void whisper_filter(size_t id, const char* chan, char* msg, size_t len){
 	}
 }
 
-static void whisper_unknown(const char* event, const char* origin, const char** params, size_t n){
-	if(strcmp(event, "WHISPER") == 0 && origin && n >= 2){
-		ctx->gen_event(IRC_CB_PM, origin, params[1]);
+static void whisper_twitch(const IRCTwitchEvent* ev){
+	if(ev->type == IRC_TWITCH_WHISPER){
+		ctx->gen_event(IRC_CB_PM, ev->name, ev->msg);
 	}
 }
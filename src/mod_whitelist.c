@@ -2,6 +2,7 @@
 #include <stdlib.h>
 #include <string.h>
 #include <stdio.h>
+#include <alloca.h>
 #include "stb_sb.h" 
 
 static bool whitelist_init    (const IRCCoreCtx*);
@@ -99,9 +100,44 @@ static inline bool admin_check(const char* name){
 	return role_check(name, ROLE_ADMIN);
 }
 
+// journal records are "+name" or "-name" for whitelisting / unwhitelisting someone since the last save.
+static void whitelist_replay(const void* data, size_t len, void* arg){
+	if(len < 2) return;
+
+	const char* rec = data;
+	char* name = strndup(rec + 1, len - 1);
+
+	if(*rec == '+'){
+		WLEntry wle = { .name = name, .role = ROLE_WHITELISTED };
+		sb_push(wlist, wle);
+		return;
+	}
+
+	for(WLEntry* wle = wlist; wle < sb_end(wlist); ++wle){
+		if(wle->role == ROLE_WHITELISTED && strcasecmp(wle->name, name) == 0){
+			free(wle->name);
+			sb_erase(wlist, wle - wlist);
+			break;
+		}
+	}
+	free(name);
+}
+
+static void whitelist_journal(char op, const char* name){
+	size_t len = strlen(name);
+	char* rec = alloca(len + 1);
+	*rec = op;
+	memcpy(rec + 1, name, len);
+
+	if(!ctx->journal_append(rec, len + 1)){
+		ctx->save_me();
+	}
+}
+
 static bool whitelist_init(const IRCCoreCtx* _ctx){
 	ctx = _ctx;
 	whitelist_load();
+	ctx->journal_replay(&whitelist_replay, NULL);
 	return true;
 }
 
@@ -151,7 +187,7 @@ static void whitelist_cmd(const char* chan, const char* name, const char* arg, i
 				ctx->send_msg(chan, "%s: Whitelisted %s.", name, arg);
 				WLEntry wle = { .name = strdup(arg), .role = ROLE_WHITELISTED };
 				sb_push(wlist, wle);
-				ctx->save_me();
+				whitelist_journal('+', arg);
 			}
 		} break;
 
@@ -169,7 +205,7 @@ static void whitelist_cmd(const char* chan, const char* name, const char* arg, i
 					ctx->send_msg(chan, "%s: Unwhitelisted %s.", name, arg);
 					free(wle->name);
 					sb_erase(wlist, wle - wlist);
-					ctx->save_me();
+					whitelist_journal('-', arg);
 					found = true;
 					break;
 				}
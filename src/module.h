@@ -8,6 +8,10 @@
 
 typedef struct IRCCoreCtx_ IRCCoreCtx;
 typedef struct IRCModMsg_ IRCModMsg;
+typedef struct IRCHTTPOpts_ IRCHTTPOpts;
+typedef struct IRCHTTPResult_ IRCHTTPResult;
+typedef struct IRCTwitchEvent_ IRCTwitchEvent;
+typedef struct IRCCallStats_ IRCCallStats;
 
 // defined by a module to provide info & callbacks to the core.
 typedef struct IRCModuleCtx_ {
@@ -34,12 +38,13 @@ typedef struct IRCModuleCtx_ {
 	void (*on_cmd)     (const char* chan, const char* name, const char* arg, int cmd);
 
 	// called to request the module saves any data it needs, return true to complete the save
-	bool (*on_save)    (FILE* file);
+	bool (*on_save)    (FILE* file); // with INSOBOT_BG_SAVE, save_me runs this in a forked child
 
 	// called when the module's data file is modified externally
 	void (*on_modified)(void);
 
-	// called before other callbacks to allow per-channel modules
+	// called before other callbacks to allow per-channel modules.
+	// the core caches the result per channel, call perms_changed if it would now return something different.
 	bool (*on_meta)    (const char* modname, const char* chan, int callback_id);
 
 	// simple inter-module communication callback
@@ -65,16 +70,46 @@ typedef struct IRCModuleCtx_ {
 	// called on an unknown IRC event
 	void (*on_unknown) (const char* event, const char* origin, const char** params, size_t num_params);
 
+	// called with the nicks already in a channel when it is joined (from NAMES), may be called more than once per channel.
+	// if this isn't set, on_join is called for each nick instead.
+	void (*on_names)   (const char* chan, const char** nicks, size_t count);
+
+	// called on Twitch's USERNOTICE, ROOMSTATE, USERSTATE, CLEARCHAT and WHISPER events, which skip on_unknown.
+	void (*on_twitch)  (const IRCTwitchEvent* ev);
+
+	// called when the module is hot-reloaded, after on_save and before on_quit, to hand its state straight to the new
+	// instance so it doesn't have to load it again. Return a malloc'd blob and set *version, or NULL to skip it.
+	// The core frees the blob with free() whether it's imported or not, so it must be self-contained (no pointers).
+	void* (*on_export_state)(size_t* len, uint32_t* version);
+
+	// called instead of on_init by the new instance with what the old one exported. Return false (e.g. for a version it
+	// doesn't know) to have on_init called instead. If it returns true, on_connect / on_join / on_names aren't replayed.
+	bool  (*on_import_state)(const IRCCoreCtx* ctx, const void* data, size_t len, uint32_t version);
+
 } IRCModuleCtx;
 
 // incremented when new functions are added to IRCCoreCtx
-#define INSO_CORE_API_VERSION 3
+#define INSO_CORE_API_VERSION 17
 
 // API version history:
 // 1: Initial version.
 // 2: send_msg and send_raw now return an ID for the message.
 //    This will be passed to the filter function of IRCModuleCtx.
 // 3: Added gen_event function
+// 4: Added watch_fd function
+// 5: Added http_request function
+// 6: Added run_async function
+// 7: Added perms_changed function
+// 8: Added intern function
+// 9: Added get_tag_by_name function
+// 10: Added add_timer and cancel_timer functions
+// 11: Added log_at and set_log_level functions
+// 12: Added journal_append and journal_replay functions
+// 13: Added warm_get and warm_commit functions
+// 14: Added init_later and init_done functions
+// 15: Added get_call_stats function
+// 16: Added intern_ref and intern_release functions
+// 17: Added cancelled function
 
 // passed to modules to provide functions for them to use.
 struct IRCCoreCtx_ {
@@ -94,22 +129,126 @@ struct IRCCoreCtx_ {
 	void           (*send_ipc)     (int target, const void* data, size_t data_len); // target 0 == broadcast
 	void           (*send_mod_msg) (IRCModMsg* msg);
 	void           (*save_me)      (void);
-	void           (*log)          (const char* fmt, ...) __attribute__ ((format (printf, 1, 2)));
+	void           (*log)          (const char* fmt, ...) __attribute__ ((format (printf, 1, 2))); // main thread only
 	void           (*strip_colors) (char* msg);
 	bool           (*responded)    (void); // true if send_msg was called for the current msg already
 	bool           (*get_tag)      (size_t index, const char** k, const char** v); // IRCv3 tag iteration (if available)
 
 	// === Since API v3 ===
 	// Queues a synthetic IRC event that will trigger modules' callbacks as if it were an event from the IRC Server.
+	// It is handled by the main loop after the current callback returns, the args are copied.
 	// The variadic args should be the same as for the corresponding on_ callback in IRCModuleCtx.
 	// Supported callbacks are in the enum below.
 	void           (*gen_event)    (int which, ...);
+
+	// === Since API v4 ===
+	// Adds fd to the core's event loop, cb will be called with the IRC_FD_* flags that are ready.
+	// Calling it again for the same fd changes the events / callback, events == 0 removes it.
+	// Remove the fd before closing it. All of a module's fds are removed when it is unloaded.
+	void           (*watch_fd)     (int fd, int events, void (*cb)(int fd, int events, void* arg), void* arg);
+
+	// === Since API v5 ===
+	// Starts an HTTP request that is performed by the main loop without blocking, cb is called when it finishes.
+	// opts can be NULL for a plain GET. Returns false (and cb won't be called) if the request couldn't be started.
+	// Requests still in progress when a module is unloaded are cancelled, and cb is called with cancelled() true.
+	bool           (*http_request) (const char* url, const IRCHTTPOpts* opts, void (*cb)(const IRCHTTPResult* res, void* arg), void* arg);
+
+	// === Since API v6 ===
+	// Runs work(arg) on a worker thread, then done(arg) back on the main thread once it has finished.
+	// work must not call any of these IRCCoreCtx functions or touch state that the module uses elsewhere.
+	// When a module is unloaded, its running jobs are waited for, then done is called for all of them with cancelled()
+	// true, including ones whose work never ran.
+	void           (*run_async)    (void (*work)(void* arg), void (*done)(void* arg), void* arg);
+
+	// === Since API v7 ===
+	// Tells the core that on_meta results have changed for chan (or all channels if NULL),
+	// so that it stops using the ones it has cached.
+	void           (*perms_changed)(const char* chan);
+
+	// === Since API v8 ===
+	// Returns a shared copy of a nick or channel, lowercased using RFC1459 casemapping.
+	// Names that only differ by case give the same pointer, so can be compared with ==.
+	// The pointer stays valid until the bot exits, even across module reloads. Returns NULL for NULL.
+	// Every name given out by it is kept forever, use intern_ref for ones that come and go like chatters' nicks.
+	const char*    (*intern)       (const char* str);
+
+	// === Since API v9 ===
+	// Returns the (unescaped) value of the current message's IRCv3 tag called key, or NULL if it doesn't have it.
+	const char*    (*get_tag_by_name)(const char* key);
+
+	// === Since API v10 ===
+	// Calls cb(id, arg) from the main loop after delay_ms, then every repeat_ms after that if it isn't 0.
+	// Returns the timer's id (never 0) for cancel_timer. All of a module's timers are cancelled when it is unloaded.
+	int            (*add_timer)    (int delay_ms, int repeat_ms, void (*cb)(int id, void* arg), void* arg);
+	void           (*cancel_timer) (int id);
+
+	// === Since API v11 ===
+	// Like log, but at one of the IRC_LOG_* levels below. Messages under the calling module's level are dropped.
+	// set_log_level changes a module's level (or the core's, if mod_name is NULL), returns false if there's no such module.
+	// Like log, only call it from the main thread (not from run_async work or an IRC_MOD_INIT_THREAD on_init).
+	void           (*log_at)       (int level, const char* fmt, ...) __attribute__ ((format (printf, 2, 3)));
+	bool           (*set_log_level)(const char* mod_name, int level);
+
+	// === Since API v12 ===
+	// Appends a record to the module's journal, so a small change can be saved without rewriting the whole data file.
+	// Returns false if it couldn't be written, save_me still works as a fallback.
+	// journal_replay calls cb with each record added since the data file was last saved, oldest first. Call it in on_init
+	// after loading the data file. on_save is used to compact the journal when it gets big, and a save (or the data file
+	// being modified) clears it, so on_save needs to write out everything the records describe.
+	bool           (*journal_append)(const void* data, size_t len);
+	void           (*journal_replay)(void (*cb)(const void* data, size_t len, void* arg), void* arg);
+
+	// === Since API v13 ===
+	// Returns size bytes of memory called name (per module) that is kept by the parent process when it restarts the bot
+	// after a crash. *restored is set if it still holds what was there at the last warm_commit with the same version and size,
+	// otherwise it's zeroed. A crash between changing it and calling warm_commit means it'll be zeroed on restart.
+	// It can't hold pointers to anything outside of it. Returns NULL without a parent process (INSOBOT_NO_FORK) or space.
+	void*          (*warm_get)     (const char* name, size_t size, uint32_t version, bool* restored);
+	void           (*warm_commit)  (void* mem);
+
+	// === Since API v14 ===
+	// Called in on_init to finish initializing later (e.g. from an http_request or run_async callback) without holding
+	// up the rest of startup. Until init_done is called the module gets no callbacks other than its own timers, fds,
+	// requests and jobs, and isn't in get_modules. init_done(false) unloads it as if on_init had failed.
+	void           (*init_later)   (void);
+	void           (*init_done)    (bool ok);
+
+	// === Since API v15 ===
+	// Fills out with up to max of mod_name's (or every module's, if NULL) callbacks, and how long they've taken since it was
+	// loaded, biggest total first. Returns how many there are, which can be more than max. out can be NULL to just count.
+	size_t         (*get_call_stats)(const char* mod_name, IRCCallStats* out, size_t max);
+
+	// === Since API v16 ===
+	// Like intern (and gives the same pointers), but counted: the name is freed once each intern_ref call for it has had
+	// an intern_release, unless intern was also called for it. Refs that a module doesn't release are never freed.
+	const char*    (*intern_ref)    (const char* str);
+	void           (*intern_release)(const char* str);
+
+	// === Since API v17 ===
+	// True when an http_request cb or run_async done is only being called so that its arg can be freed, because the
+	// module is being unloaded. The request's status is -CURLE_ABORTED_BY_CALLBACK, and work may not have run.
+	// http_request fails and run_async calls done straight away while it's true.
+	bool           (*cancelled)    (void);
+};
+
+enum {
+	IRC_INFO_CAN_PARSE_TAGS,       // bool
+	IRC_INFO_CMD_QUEUE_DEPTH,      // number of commands currently queued to be sent
+	IRC_INFO_CMD_QUEUE_HIGH_WATER, // most commands that have been queued at once
+	IRC_INFO_CMD_QUEUE_DROPPED,    // commands dropped due to a full queue or expiring
 };
 
+// used for log_at & set_log_level, log uses IRC_LOG_INFO.
 enum {
-	IRC_INFO_CAN_PARSE_TAGS, // bool
+	IRC_LOG_DEBUG,
+	IRC_LOG_INFO,
+	IRC_LOG_WARN,
+	IRC_LOG_ERROR,
 };
 
+// names for the IRC_LOG_* levels, in order, as accepted by INSOBOT_LOG_LEVEL
+#define IRC_LOG_LEVEL_NAMES { "debug", "info", "warn", "error" }
+
 // used for on_meta callback & gen_event.
 enum  {
 	IRC_CB_MSG,
@@ -121,10 +260,83 @@ enum  {
 	IRC_CB_PM,
 };
 
+// used for watch_fd
+enum {
+	IRC_FD_READ  = 1,
+	IRC_FD_WRITE = 2,
+	IRC_FD_ERROR = 4, // passed to the callback only, on error or hangup
+};
+
 // used for the flags field of IRCModuleCtx
 enum {
-	IRC_MOD_GLOBAL  = 1, // not a module that can be enabled / disabled per channel
-	IRC_MOD_DEFAULT = 2, // enabled by default when joining new channels
+	IRC_MOD_GLOBAL      = 1, // not a module that can be enabled / disabled per channel
+	IRC_MOD_DEFAULT     = 2, // enabled by default when joining new channels
+	IRC_MOD_INIT_THREAD = 4, // on_init runs on a worker thread alongside other modules' init, so it can't call IRCCoreCtx functions
+};
+
+// used for http_request
+struct IRCHTTPOpts_ {
+	void*        curl;      // optional CURL* set up by the module (e.g. with inso_curl_reset), the core takes ownership of it
+	const char** headers;   // optional null-terminated list of extra headers
+	const char*  post_data; // if set, the request will be a POST with this body
+	long         timeout;   // in seconds, 0 = default (8s)
+};
+
+struct IRCHTTPResult_ {
+	long   status;   // http response code, or -CURLcode on error (like inso_curl_perform)
+	char*  data;     // null-terminated response body, freed after the callback returns
+	size_t data_len;
+	void*  curl;     // the CURL* used, for curl_easy_getinfo etc. Cleaned up after the callback returns
+};
+
+// used for on_twitch
+enum {
+	IRC_TWITCH_USERNOTICE, // sub, resub, raid etc. msg_id says which
+	IRC_TWITCH_ROOMSTATE,  // channel settings, sent on join and when they change
+	IRC_TWITCH_USERSTATE,  // the bot's own state in a channel, sent on join and after each msg it sends
+	IRC_TWITCH_CLEARCHAT,  // timeout / ban of name, or the whole chat if name is NULL
+	IRC_TWITCH_WHISPER,    // private msg from name
+};
+
+// room_changed bits, ROOMSTATE only includes settings that changed (except the first one on join)
+enum {
+	IRC_ROOM_SLOW       = 1 << 0,
+	IRC_ROOM_FOLLOWERS  = 1 << 1,
+	IRC_ROOM_SUBS_ONLY  = 1 << 2,
+	IRC_ROOM_EMOTE_ONLY = 1 << 3,
+	IRC_ROOM_R9K        = 1 << 4,
+};
+
+struct IRCTwitchEvent_ {
+	int         type;       // IRC_TWITCH_*
+	const char* chan;       // NULL for WHISPER
+	const char* name;       // the user the event is about, may be NULL
+	const char* msg;        // USERNOTICE: msg the user attached (may be NULL), WHISPER: the msg
+	const char* msg_id;     // USERNOTICE: "sub", "resub", "raid" etc
+	const char* system_msg; // USERNOTICE: twitch's description of the event
+	int         duration;   // CLEARCHAT: timeout in seconds, 0 for a permanent ban or clearing the whole chat
+	bool        is_mod;     // USERSTATE: if the bot is a mod in chan
+
+	// ROOMSTATE, only valid for the settings set in room_changed
+	int         room_changed;
+	int         slow;       // seconds between messages, 0 = off
+	int         followers;  // minutes following required, -1 = off
+	bool        subs_only;
+	bool        emote_only;
+	bool        r9k;
+};
+
+// used for get_call_stats. a callback's time includes any others called from inside it, e.g. on_msg_out from send_msg.
+// the percentiles are accurate to within 1/8th.
+struct IRCCallStats_ {
+	const char* module;
+	const char* callback; // e.g. "on_cmd", or "timer", "watch_fd", "http_request", "run_async" for those callbacks
+	uint64_t    count;
+	uint64_t    total_ns;
+	uint64_t    p50_ns;
+	uint64_t    p90_ns;
+	uint64_t    p99_ns;
+	uint64_t    max_ns;
 };
 
 // used for inter-module communication messages
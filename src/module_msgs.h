@@ -126,8 +126,20 @@ typedef struct {
 //   if that isn't available, then *arg* is returned in *result* as a fallback.
 //  twitch_get_user_date:
 //    *result* will be the epoch time that the user given in *arg* created their account.
+//    Only users that have been looked up before get an answer straight away. For others, the
+//    callback isn't called, and "twitch_user_date" is sent once twitch replies.
+//  twitch_user_date:
+//    Sent by mod_twitch to every module when a lookup started by twitch_get_user_date finishes.
+//    *arg* is the TwitchUserDate below, and there is no callback.
 //  twitch_is_live:
 //    *result* will be true/false if any of the channels given in *arg* are live or not.
+//    This is the last known state, channels that haven't been checked recently are refreshed
+//    in the background.
+
+typedef struct {
+	const char* name;
+	time_t created_at;
+} TwitchUserDate;
 
 // WHITELIST:
 //  check_admin: